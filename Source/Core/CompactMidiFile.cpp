@@ -0,0 +1,251 @@
+#include "CompactMidiFile.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+    juce::uint32 readBigEndian32(const juce::uint8* p) noexcept
+    {
+        return (static_cast<juce::uint32>(p[0]) << 24) | (static_cast<juce::uint32>(p[1]) << 16)
+             | (static_cast<juce::uint32>(p[2]) << 8) | static_cast<juce::uint32>(p[3]);
+    }
+
+    juce::uint16 readBigEndian16(const juce::uint8* p) noexcept
+    {
+        return static_cast<juce::uint16>((p[0] << 8) | p[1]);
+    }
+
+    // At most four bytes, as the format allows; false if the data ends first
+    bool readVariableLength(const juce::uint8* data, size_t size, size_t& pos, juce::uint32& value) noexcept
+    {
+        value = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if (pos >= size)
+                return false;
+
+            const juce::uint8 byte = data[pos++];
+            value = (value << 7) | (byte & 0x7fu);
+
+            if ((byte & 0x80) == 0)
+                return true;
+        }
+
+        return false;
+    }
+}
+
+bool CompactMidiFile::load(const juce::File& file)
+{
+    const juce::MemoryMappedFile mappedFile(file, juce::MemoryMappedFile::readOnly);
+    if (mappedFile.getData() == nullptr)
+    {
+        clear();
+        return false;
+    }
+
+    return readFrom(mappedFile.getData(), mappedFile.getSize());
+}
+
+bool CompactMidiFile::readFrom(const void* sourceData, size_t size)
+{
+    clear();
+
+    const auto* data = static_cast<const juce::uint8*>(sourceData);
+
+    if (data == nullptr || size < 14 || std::memcmp(data, "MThd", 4) != 0)
+        return false;
+
+    const juce::uint32 headerLength = readBigEndian32(data + 4);
+    if (headerLength < 6 || headerLength > size - 8)
+        return false;
+
+    const int expectedTracks = readBigEndian16(data + 10);
+    timeFormat = static_cast<short>(readBigEndian16(data + 12));
+
+    // Channel messages take at least three bytes with their delta, so this is one allocation
+    events.reserve(size / 3);
+
+    size_t pos = 8 + headerLength;
+
+    while (numTracks < expectedTracks && size - pos >= 8)
+    {
+        const juce::uint32 chunkLength = readBigEndian32(data + pos + 4);
+        const bool isTrack = std::memcmp(data + pos, "MTrk", 4) == 0;
+        pos += 8;
+
+        // A truncated last chunk is read as far as it goes, like juce::MidiFile does
+        const size_t available = juce::jmin(static_cast<size_t>(chunkLength), size - pos);
+
+        if (isTrack)
+        {
+            if (!readTrack(data + pos, available, numTracks))
+            {
+                clear();
+                return false;
+            }
+
+            ++numTracks;
+        }
+
+        pos += available;
+    }
+
+    // Each track is already in tick order, so this only interleaves them
+    auto byTick = [](const auto& a, const auto& b) { return a.tick < b.tick; };
+
+    if (numTracks > 1)
+    {
+        std::stable_sort(events.begin(), events.end(), byTick);
+        std::stable_sort(tempoChanges.begin(), tempoChanges.end(), byTick);
+        std::stable_sort(timeSignatures.begin(), timeSignatures.end(), byTick);
+        std::stable_sort(otherEvents.begin(), otherEvents.end(), byTick);
+    }
+
+    // The reserve above assumed the densest encoding; cached files should only pay for what they hold
+    events.shrink_to_fit();
+    otherEvents.shrink_to_fit();
+    otherEventData.shrink_to_fit();
+
+    return true;
+}
+
+bool CompactMidiFile::readTrack(const juce::uint8* data, size_t size, int trackIndex)
+{
+    const auto track = static_cast<juce::uint8>(juce::jmin(trackIndex, 255));
+
+    size_t pos = 0;
+    juce::uint64 tick = 0;
+    juce::uint8 runningStatus = 0;
+
+    while (pos < size)
+    {
+        juce::uint32 delta = 0;
+        if (!readVariableLength(data, size, pos, delta) || pos >= size)
+            break;   // Ends without an end-of-track event
+
+        tick += delta;
+        if (tick > std::numeric_limits<juce::uint32>::max())
+            return false;
+
+        const auto eventTick = static_cast<juce::uint32>(tick);
+        const size_t eventStart = pos;
+
+        juce::uint8 status = data[pos];
+        if ((status & 0x80) != 0)
+            ++pos;
+        else if (runningStatus != 0)
+            status = runningStatus;
+        else
+            return false;
+
+        if (status == 0xff)
+        {
+            if (pos >= size)
+                break;
+
+            const juce::uint8 type = data[pos++];
+            juce::uint32 length = 0;
+            if (!readVariableLength(data, size, pos, length) || length > size - pos)
+                break;
+
+            const juce::uint8* payload = data + pos;
+            pos += length;
+            lastTick = juce::jmax(lastTick, eventTick);
+
+            if (type == 0x51 && length >= 3)
+            {
+                const juce::uint32 microseconds = (static_cast<juce::uint32>(payload[0]) << 16)
+                                                | (static_cast<juce::uint32>(payload[1]) << 8) | payload[2];
+                if (microseconds > 0)
+                    tempoChanges.push_back({ eventTick, microseconds });
+            }
+            else if (type == 0x58 && length >= 2 && payload[0] > 0 && payload[1] < 8)
+            {
+                timeSignatures.push_back({ eventTick, payload[0], static_cast<juce::uint8>(1u << payload[1]) });
+            }
+            else if (type == 0x2f)
+            {
+                break;
+            }
+            else
+            {
+                // Already in juce::MidiMessage layout
+                addOtherEvent(eventTick, status, track, data + eventStart, pos - eventStart, nullptr, 0);
+            }
+
+            continue;
+        }
+
+        if (status == 0xf0 || status == 0xf7)
+        {
+            juce::uint32 length = 0;
+            if (!readVariableLength(data, size, pos, length) || length > size - pos)
+                break;
+
+            // Stored without the length, as juce::MidiMessage has it
+            addOtherEvent(eventTick, status, track, &status, 1, data + pos, length);
+
+            pos += length;
+            lastTick = juce::jmax(lastTick, eventTick);
+            continue;
+        }
+
+        // System common and real-time messages can't appear in a file
+        if (status > 0xf0)
+            return false;
+
+        runningStatus = status;
+
+        // Program change and channel pressure have one data byte
+        const size_t numDataBytes = (status & 0xe0) == 0xc0 ? 1 : 2;
+        if (numDataBytes > size - pos)
+            break;
+
+        CompactMidiEvent event;
+        event.tick = eventTick;
+        event.status = status;
+        event.data1 = static_cast<juce::uint8>(data[pos] & 0x7f);
+        event.data2 = numDataBytes == 2 ? static_cast<juce::uint8>(data[pos + 1] & 0x7f) : 0;
+        event.track = track;
+        pos += numDataBytes;
+
+        events.push_back(event);
+        lastTick = juce::jmax(lastTick, eventTick);
+    }
+
+    return true;
+}
+
+void CompactMidiFile::addOtherEvent(juce::uint32 tick, juce::uint8 status, juce::uint8 track,
+                                    const juce::uint8* head, size_t headSize, const juce::uint8* body, size_t bodySize)
+{
+    const size_t eventSize = headSize + bodySize;
+    if (eventSize > std::numeric_limits<juce::uint32>::max() - otherEventData.size())
+        return;
+
+    otherEvents.push_back({ tick, static_cast<juce::uint32>(otherEventData.size()), static_cast<juce::uint32>(eventSize), status, track });
+    otherEventData.insert(otherEventData.end(), head, head + headSize);
+
+    if (bodySize > 0)
+        otherEventData.insert(otherEventData.end(), body, body + bodySize);
+}
+
+double CompactMidiFile::getFirstBpm() const noexcept
+{
+    return tempoChanges.empty() ? 0.0 : 60000000.0 / tempoChanges.front().microsecondsPerQuarterNote;
+}
+
+void CompactMidiFile::clear() noexcept
+{
+    timeFormat = 0;
+    numTracks = 0;
+    lastTick = 0;
+    events.clear();
+    tempoChanges.clear();
+    timeSignatures.clear();
+    otherEvents.clear();
+    otherEventData.clear();
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <vector>
+
+/**
+ * One channel voice message of a CompactMidiFile.
+ */
+struct CompactMidiEvent
+{
+    juce::uint32 tick = 0;        // Absolute, in file ticks
+    juce::uint8 status = 0;       // Including the channel
+    juce::uint8 data1 = 0;        // Note, controller or program
+    juce::uint8 data2 = 0;        // Velocity or value; 0 for two-byte messages
+    juce::uint8 track = 0;        // Clamped to 255
+
+    bool isNoteOn() const noexcept        { return (status & 0xf0) == 0x90 && data2 > 0; }
+    bool isNoteOff() const noexcept       { return (status & 0xf0) == 0x80 || ((status & 0xf0) == 0x90 && data2 == 0); }
+    int getChannel() const noexcept       { return (status & 0x0f) + 1; }
+};
+
+/**
+ * Read-only Standard MIDI File reader for code that only looks at notes and
+ * timing, such as clip drawing, duration checks and note sampling.
+ *
+ * The file is memory-mapped and decoded in one pass over each track chunk:
+ * variable-length deltas and running status go straight into one flat array of
+ * 8-byte events, merged across tracks in tick order, so reading a file costs
+ * one allocation instead of one juce::MidiEventHolder per event. Tempo and
+ * time signature changes are kept in arrays of their own. The remaining meta
+ * and sysex events, which are rare, are copied into one byte buffer, so an
+ * export can pass them on. Every read is bounds-checked, so truncated or
+ * malformed files fail cleanly instead of reading past the mapping.
+ *
+ * Code that hands the file on as a juce::MidiMessageSequence (dissection,
+ * export) keeps using juce::MidiFile.
+ */
+class CompactMidiFile
+{
+public:
+    struct TempoChange
+    {
+        juce::uint32 tick;
+        juce::uint32 microsecondsPerQuarterNote;
+    };
+
+    struct TimeSignature
+    {
+        juce::uint32 tick;
+        juce::uint8 numerator;
+        juce::uint8 denominator;
+    };
+
+    // A meta event other than tempo, time signature and end of track, or a sysex event.
+    // Its bytes are laid out as in a juce::MidiMessage: 0xff, type, length and data for
+    // meta events, the status byte and data for sysex.
+    struct OtherEvent
+    {
+        juce::uint32 tick;
+        juce::uint32 offset;     // Into the other event data
+        juce::uint32 size;
+        juce::uint8 status;      // 0xff, 0xf0 or 0xf7
+        juce::uint8 track;
+
+        bool isMetaEvent() const noexcept     { return status == 0xff; }
+    };
+
+    CompactMidiFile() = default;
+
+    bool load(const juce::File& file);
+    bool readFrom(const void* data, size_t size);
+
+    // Positive ticks per quarter note, or a negative SMPTE format as in juce::MidiFile
+    short getTimeFormat() const noexcept { return timeFormat; }
+    int getTicksPerQuarterNote(int fallback = 480) const noexcept { return timeFormat > 0 ? timeFormat : fallback; }
+
+    int getNumTracks() const noexcept { return numTracks; }
+    juce::uint32 getLastTick() const noexcept { return lastTick; }
+
+    // Sorted by tick; events at the same tick keep their track and file order
+    const std::vector<CompactMidiEvent>& getEvents() const noexcept { return events; }
+    const std::vector<TempoChange>& getTempoChanges() const noexcept { return tempoChanges; }
+    const std::vector<TimeSignature>& getTimeSignatures() const noexcept { return timeSignatures; }
+    const std::vector<OtherEvent>& getOtherEvents() const noexcept { return otherEvents; }
+
+    const juce::uint8* getOtherEventData(const OtherEvent& event) const noexcept { return otherEventData.data() + event.offset; }
+    size_t getOtherEventDataSize() const noexcept { return otherEventData.size(); }
+
+    // The first tempo change, 0 if there is none
+    double getFirstBpm() const noexcept;
+
+    void clear() noexcept;
+
+private:
+    bool readTrack(const juce::uint8* data, size_t size, int trackIndex);
+    void addOtherEvent(juce::uint32 tick, juce::uint8 status, juce::uint8 track,
+                       const juce::uint8* head, size_t headSize, const juce::uint8* body, size_t bodySize);
+
+    short timeFormat = 0;
+    int numTracks = 0;
+    juce::uint32 lastTick = 0;
+
+    std::vector<CompactMidiEvent> events;
+    std::vector<TempoChange> tempoChanges;
+    std::vector<TimeSignature> timeSignatures;
+    std::vector<OtherEvent> otherEvents;
+    std::vector<juce::uint8> otherEventData;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CompactMidiFile)
+};
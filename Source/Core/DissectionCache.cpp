@@ -0,0 +1,217 @@
+#include "DissectionCache.h"
+#include "DrumLibraryManager.h"
+
+DissectionCache::DissectionCache(const DrumLibraryManager& manager)
+    : libraryManager(manager)
+{
+}
+
+juce::Array<DrumPart> DissectionCache::getDrumParts(const juce::File& midiFile,
+                                                    DrumLibrary sourceLibrary,
+                                                    DrumLibrary targetLibrary)
+{
+    if (!midiFile.existsAsFile())
+        return {};
+
+    const juce::String path = midiFile.getFullPathName();
+    const juce::int64 size = midiFile.getSize();
+    const juce::int64 modTime = midiFile.getLastModificationTime().toMilliseconds();
+
+    juce::MemoryBlock fileData;
+    juce::uint64 contentHash = 0;
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        auto stamp = fileStamps.find(path);
+        if (stamp != fileStamps.end() && stamp->second.size == size && stamp->second.modificationTime == modTime)
+        {
+            contentHash = stamp->second.contentHash;
+
+            auto entry = entries.find({ contentHash, sourceLibrary });
+            if (entry != entries.end())
+            {
+                entry->second.lastUsed = ++useCounter;
+                return getProjection(entry->second, sourceLibrary, targetLibrary);
+            }
+        }
+    }
+
+    // Miss: read the file once, hash it and parse from the same bytes
+    if (!midiFile.loadFileAsData(fileData))
+    {
+        DBG("DissectionCache: Failed to read " + path);
+        return {};
+    }
+
+    contentHash = hashContent(fileData);
+
+    {
+        const juce::ScopedLock sl(lock);
+        fileStamps[path] = { size, modTime, contentHash };
+
+        // Same content may already be cached under another path
+        auto entry = entries.find({ contentHash, sourceLibrary });
+        if (entry != entries.end())
+        {
+            entry->second.lastUsed = ++useCounter;
+            return getProjection(entry->second, sourceLibrary, targetLibrary);
+        }
+    }
+
+    juce::MemoryInputStream inputStream(fileData, false);
+    juce::MidiFile midiFileData;
+    if (!midiFileData.readFrom(inputStream))
+    {
+        DBG("DissectionCache: Failed to parse " + path);
+        return {};
+    }
+
+    auto sourceParts = dissector.dissectSourceParts(midiFileData, sourceLibrary, libraryManager);
+
+    DBG("DissectionCache: Dissected " + midiFile.getFileName() + " (" + juce::String(sourceParts.size()) + " parts)");
+
+    const juce::ScopedLock sl(lock);
+
+    auto& entry = entries[{ contentHash, sourceLibrary }];
+    memoryUsed -= entry.bytes;
+    entry.sourceParts = sourceParts;
+    entry.projections.clear();
+    entry.bytes = estimateSize(sourceParts);
+    entry.lastUsed = ++useCounter;
+    memoryUsed += entry.bytes;
+
+    auto parts = getProjection(entry, sourceLibrary, targetLibrary);
+    evictToMemoryLimit();
+    return parts;
+}
+
+juce::Array<DrumPart> DissectionCache::getRemappedDrumParts(const juce::File& midiFile,
+                                                            DrumLibrary sourceLibrary,
+                                                            DrumLibrary targetLibrary)
+{
+    {
+        const juce::ScopedLock sl(lock);
+
+        auto stamp = fileStamps.find(midiFile.getFullPathName());
+        if (stamp != fileStamps.end())
+        {
+            auto entry = entries.find({ stamp->second.contentHash, sourceLibrary });
+            if (entry != entries.end())
+            {
+                entry->second.lastUsed = ++useCounter;
+                return getProjection(entry->second, sourceLibrary, targetLibrary);
+            }
+        }
+    }
+
+    return getDrumParts(midiFile, sourceLibrary, targetLibrary);
+}
+
+void DissectionCache::invalidate(const juce::File& midiFile)
+{
+    // The content entry stays until evicted - other paths may share it
+    const juce::ScopedLock sl(lock);
+    fileStamps.erase(midiFile.getFullPathName());
+}
+
+void DissectionCache::clear()
+{
+    const juce::ScopedLock sl(lock);
+    entries.clear();
+    fileStamps.clear();
+    memoryUsed = 0;
+}
+
+int DissectionCache::getNumEntries() const
+{
+    const juce::ScopedLock sl(lock);
+    return static_cast<int>(entries.size());
+}
+
+void DissectionCache::setMemoryLimit(size_t bytes)
+{
+    const juce::ScopedLock sl(lock);
+    memoryLimit = bytes;
+    evictToMemoryLimit();
+}
+
+size_t DissectionCache::getMemoryLimit() const
+{
+    const juce::ScopedLock sl(lock);
+    return memoryLimit;
+}
+
+size_t DissectionCache::getMemoryUsage() const
+{
+    const juce::ScopedLock sl(lock);
+    return memoryUsed;
+}
+
+juce::Array<DrumPart> DissectionCache::getProjection(CacheEntry& entry, DrumLibrary sourceLibrary, DrumLibrary targetLibrary)
+{
+    // Bypass and same-library targets are the source parts themselves
+    if (targetLibrary == DrumLibrary::Bypass || targetLibrary == sourceLibrary)
+        return entry.sourceParts;
+
+    auto projection = entry.projections.find(targetLibrary);
+    if (projection == entry.projections.end())
+    {
+        projection = entry.projections.emplace(targetLibrary,
+            MidiDissector::remapDrumPartsToTarget(entry.sourceParts, sourceLibrary, targetLibrary, libraryManager)).first;
+
+        const auto bytes = estimateSize(projection->second);
+        entry.bytes += bytes;
+        memoryUsed += bytes;
+    }
+
+    return projection->second;
+}
+
+juce::uint64 DissectionCache::hashContent(const juce::MemoryBlock& data)
+{
+    // FNV-1a, 64 bit
+    juce::uint64 hash = 14695981039346656037ULL;
+    auto* bytes = static_cast<const juce::uint8*>(data.getData());
+
+    for (size_t i = 0; i < data.getSize(); ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+size_t DissectionCache::estimateSize(const juce::Array<DrumPart>& parts)
+{
+    constexpr size_t bytesPerEvent = sizeof(juce::MidiMessageSequence::MidiEventHolder) + sizeof(void*);
+    size_t bytes = 0;
+
+    for (const auto& part : parts)
+    {
+        bytes += sizeof(DrumPart) + sizeof(DrumPartData)
+               + static_cast<size_t>(part.getSequence().getNumEvents()) * bytesPerEvent
+               + static_cast<size_t>(part.getOriginalNotes().size() + part.getRemappedNotes().size());
+    }
+
+    return bytes;
+}
+
+void DissectionCache::evictToMemoryLimit()
+{
+    // The most recent entry always stays, however large
+    while (memoryUsed > memoryLimit && entries.size() > 1)
+    {
+        auto oldest = entries.begin();
+
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+        {
+            if (it->second.lastUsed < oldest->second.lastUsed)
+                oldest = it;
+        }
+
+        memoryUsed -= oldest->second.bytes;
+        entries.erase(oldest);
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <map>
+#include <unordered_map>
+#include "MidiDissector.h"
+
+class DrumLibraryManager;
+
+/**
+ * Shared cache of dissected drum parts.
+ *
+ * Entries are keyed by a hash of the MIDI file's bytes plus the source library, so the browser,
+ * the parts column and the track drop paths all reuse the same dissection. Parts are stored with
+ * their source notes; the projection onto each target library is built through the note map
+ * on first request and memoised, so switching target libraries needs no I/O.
+ */
+class DissectionCache
+{
+public:
+    explicit DissectionCache(const DrumLibraryManager& libraryManager);
+    ~DissectionCache() = default;
+
+    // Returns the parts of a file remapped to targetLibrary, dissecting it only on a cache miss
+    juce::Array<DrumPart> getDrumParts(const juce::File& midiFile,
+                                       DrumLibrary sourceLibrary,
+                                       DrumLibrary targetLibrary);
+
+    // Re-projects a file that was already dissected onto another target library without touching
+    // the disk. Falls back to getDrumParts() if the file is not cached.
+    juce::Array<DrumPart> getRemappedDrumParts(const juce::File& midiFile,
+                                               DrumLibrary sourceLibrary,
+                                               DrumLibrary targetLibrary);
+
+    // Forgets what is known about a path so the next request re-reads it
+    void invalidate(const juce::File& midiFile);
+
+    void clear();
+    int getNumEntries() const;
+
+    // Least recently used files are dropped once their parts take more than this
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit() const;
+    size_t getMemoryUsage() const;
+
+private:
+    struct FileStamp
+    {
+        juce::int64 size = 0;
+        juce::int64 modificationTime = 0;
+        juce::uint64 contentHash = 0;
+    };
+
+    struct CacheKey
+    {
+        juce::uint64 contentHash = 0;
+        DrumLibrary sourceLibrary = DrumLibrary::Unknown;
+
+        bool operator<(const CacheKey& other) const
+        {
+            if (contentHash != other.contentHash)
+                return contentHash < other.contentHash;
+            return static_cast<int>(sourceLibrary) < static_cast<int>(other.sourceLibrary);
+        }
+    };
+
+    struct CacheEntry
+    {
+        juce::Array<DrumPart> sourceParts;
+        std::map<DrumLibrary, juce::Array<DrumPart>> projections;
+        juce::uint32 lastUsed = 0;
+        size_t bytes = 0;     // Estimated size of the parts and projections
+    };
+
+    juce::Array<DrumPart> getProjection(CacheEntry& entry, DrumLibrary sourceLibrary, DrumLibrary targetLibrary);
+    static juce::uint64 hashContent(const juce::MemoryBlock& data);
+    static size_t estimateSize(const juce::Array<DrumPart>& parts);
+    void evictToMemoryLimit();
+
+    const DrumLibraryManager& libraryManager;
+    MidiDissector dissector;
+
+    std::unordered_map<juce::String, FileStamp> fileStamps;
+    std::map<CacheKey, CacheEntry> entries;
+    juce::uint32 useCounter = 0;
+
+    size_t memoryLimit = 64 * 1024 * 1024;
+    size_t memoryUsed = 0;
+
+    juce::CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DissectionCache)
+};
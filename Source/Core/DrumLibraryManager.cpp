@@ -1,13 +1,28 @@
 #include "DrumLibraryManager.h"
+#include "GrooveLibraryIndex.h"
+#include "GrooveSearchIndex.h"
+#include "GrooveThumbnailCache.h"
+#include "SourceLibraryDetector.h"
 
 DrumLibraryManager::DrumLibraryManager()
 {
     initializeMappingTables();
     loadConfiguration();
+    
+    sourceLibraryDetector = std::make_unique<SourceLibraryDetector>(*this);
+    libraryIndex = std::make_unique<GrooveLibraryIndex>(*this);
+    libraryIndex->load();
+    searchIndex = std::make_unique<GrooveSearchIndex>(*libraryIndex);
+    thumbnailCache = std::make_unique<GrooveThumbnailCache>(*libraryIndex);
+    updateWatchedFolders();
 }
 
 DrumLibraryManager::~DrumLibraryManager()
 {
+    thumbnailCache.reset();
+    searchIndex.reset();
+    libraryIndex->watchFolders({});
+    libraryIndex->cancelScan();
     saveConfiguration();
 }
 
@@ -19,8 +34,13 @@ void DrumLibraryManager::addRootFolder(const juce::File& folder, DrumLibrary sou
         fi.folder = folder;
         fi.sourceLibrary = sourceLib;
         
-        rootFolders.push_back(fi);
+        {
+            const juce::ScopedLock sl(rootFolderLock);
+            rootFolders.push_back(fi);
+        }
+
         saveConfiguration();
+        updateWatchedFolders();
     }
 }
 
@@ -517,6 +537,23 @@ uint8_t DrumLibraryManager::mapNoteToLibrary(uint8_t note, DrumLibrary sourceLib
     return gmNote;
 }
 
+const DrumLibraryManager::NoteMap& DrumLibraryManager::getNoteMap(DrumLibrary sourceLibrary, DrumLibrary targetLibrary) const
+{
+    const juce::ScopedLock sl(noteMapLock);
+    
+    const int key = (static_cast<int>(sourceLibrary) << 8) | static_cast<int>(targetLibrary);
+    
+    auto it = noteMaps.find(key);
+    if (it != noteMaps.end())
+        return it->second;
+    
+    NoteMap& table = noteMaps[key];
+    for (int note = 0; note < 128; ++note)
+        table[static_cast<size_t>(note)] = mapNoteToLibrary(static_cast<uint8_t>(note), sourceLibrary, targetLibrary);
+    
+    return table;
+}
+
 // Rest of the DrumLibraryManager implementation...
 juce::File DrumLibraryManager::getRootFolder(int index) const
 {
@@ -539,18 +576,84 @@ DrumLibrary DrumLibraryManager::getRootFolderSourceLibrary(int index) const
     return DrumLibrary::Unknown;
 }
 
+DrumLibrary DrumLibraryManager::getSourceLibraryFor(const juce::File& file) const
+{
+    {
+        // Also called from background threads
+        const juce::ScopedLock sl(rootFolderLock);
+
+        // The innermost root containing the file decides
+        const FolderInfo* bestRoot = nullptr;
+        for (const auto& folderInfo : rootFolders)
+        {
+            if (file.isAChildOf(folderInfo.folder)
+                && (bestRoot == nullptr || folderInfo.folder.isAChildOf(bestRoot->folder)))
+                bestRoot = &folderInfo;
+        }
+
+        if (bestRoot != nullptr && bestRoot->sourceLibrary != DrumLibrary::Unknown)
+            return bestRoot->sourceLibrary;
+    }
+
+    // No library set for the folder: use what indexing detected from the notes
+    auto snapshot = libraryIndex->getSnapshot();
+    const int row = snapshot->indexOf(file);
+    return row >= 0 ? snapshot->getDetectedLibrary(row) : DrumLibrary::Unknown;
+}
+
 void DrumLibraryManager::removeRootFolder(int index)
 {
     if (index >= 0 && index < static_cast<int>(rootFolders.size()))
     {
-        rootFolders.erase(rootFolders.begin() + index);
+        const juce::File removedFolder = rootFolders[index].folder;
+
+        {
+            const juce::ScopedLock sl(rootFolderLock);
+            rootFolders.erase(rootFolders.begin() + index);
+        }
+
         saveConfiguration();
+        updateWatchedFolders();
+
+        if (libraryIndex != nullptr)
+        {
+            std::vector<GrooveLibraryIndex::RootFolder> roots;
+            for (const auto& folderInfo : rootFolders)
+                roots.push_back({ folderInfo.folder, folderInfo.sourceLibrary });
+
+            libraryIndex->removeRoot(removedFolder, roots);
+        }
     }
 }
 
 void DrumLibraryManager::rescanFolders()
 {
-    // Placeholder for future folder scanning
+    std::vector<GrooveLibraryIndex::RootFolder> roots;
+    
+    for (const auto& folderInfo : rootFolders)
+    {
+        if (folderInfo.folder.isDirectory())
+            roots.push_back({ folderInfo.folder, folderInfo.sourceLibrary });
+    }
+    
+    // Only new or modified files are parsed again
+    libraryIndex->rescan(roots);
+}
+
+void DrumLibraryManager::updateWatchedFolders()
+{
+    if (libraryIndex == nullptr)
+        return;
+    
+    std::vector<GrooveLibraryIndex::RootFolder> roots;
+    
+    for (const auto& folderInfo : rootFolders)
+    {
+        if (folderInfo.folder.isDirectory())
+            roots.push_back({ folderInfo.folder, folderInfo.sourceLibrary });
+    }
+    
+    libraryIndex->watchFolders(roots);
 }
 
 juce::File DrumLibraryManager::getConfigFile() const
@@ -584,7 +687,7 @@ void DrumLibraryManager::loadConfiguration()
     }
 
     // Load root folders
-    rootFolders.clear();
+    std::vector<FolderInfo> loadedFolders;
 
     if (auto* foldersElement = config->getChildByName("RootFolders"))
     {
@@ -601,7 +704,7 @@ void DrumLibraryManager::loadConfiguration()
                     FolderInfo info;
                     info.folder = folder;
                     info.sourceLibrary = static_cast<DrumLibrary>(sourceLib);
-                    rootFolders.push_back(info);
+                    loadedFolders.push_back(info);
                     
                     DBG("Loaded root folder: " + folder.getFileName() + " (" + path + ")");
                 }
@@ -609,6 +712,11 @@ void DrumLibraryManager::loadConfiguration()
         }
     }
 
+    {
+        const juce::ScopedLock sl(rootFolderLock);
+        rootFolders = std::move(loadedFolders);
+    }
+
     // Load last selected target library
     int savedTargetLib = config->getIntAttribute("lastSelectedTargetLibrary", static_cast<int>(DrumLibrary::GeneralMIDI));
     lastSelectedTargetLibrary = static_cast<DrumLibrary>(savedTargetLib);
@@ -616,6 +724,9 @@ void DrumLibraryManager::loadConfiguration()
     DBG("Loaded last selected target library: " + juce::String(savedTargetLib) + 
         " (" + DrumLibraryManager::getLibraryName(lastSelectedTargetLibrary) + ")");
 
+    const int cacheMegabytes = config->getIntAttribute("cacheMemoryLimitMB", 64);
+    cacheMemoryLimit = static_cast<size_t>(juce::jlimit(4, 4096, cacheMegabytes)) * 1024 * 1024;
+
     DBG("Configuration loaded successfully");
 }
 
@@ -634,6 +745,7 @@ void DrumLibraryManager::saveConfiguration()
 
     // Save last selected target library
     config->setAttribute("lastSelectedTargetLibrary", static_cast<int>(lastSelectedTargetLibrary));
+    config->setAttribute("cacheMemoryLimitMB", static_cast<int>(cacheMemoryLimit / (1024 * 1024)));
 
     // Save to file
     juce::File configFile = getConfigFile();  // NOT getConfigFilePath()
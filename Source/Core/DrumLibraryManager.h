@@ -4,6 +4,7 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <vector>
 #include <map>
+#include <array>
 
 enum class DrumLibrary
 {
@@ -27,6 +28,11 @@ enum class DrumLibrary
     Damage2 = 17
 };
 
+class GrooveLibraryIndex;
+class GrooveSearchIndex;
+class GrooveThumbnailCache;
+class SourceLibraryDetector;
+
 class DrumLibraryManager
 {
 public:
@@ -37,13 +43,33 @@ public:
     void removeRootFolder(int index);
     void rescanFolders();
     
+    // Parsed metadata of every MIDI file below the root folders
+    GrooveLibraryIndex& getLibraryIndex() const { return *libraryIndex; }
+    
+    // Name and tag search over the library index
+    GrooveSearchIndex& getSearchIndex() const { return *searchIndex; }
+    
+    // Pattern thumbnails of the indexed files
+    GrooveThumbnailCache& getThumbnailCache() const { return *thumbnailCache; }
+    
+    // Guesses a file's or folder's source library from the notes it plays
+    const SourceLibraryDetector& getSourceLibraryDetector() const { return *sourceLibraryDetector; }
+    
     int getNumRootFolders() const { return static_cast<int>(rootFolders.size()); }
     juce::File getRootFolder(int index) const;
     juce::String getRootFolderName(int index) const;
     DrumLibrary getRootFolderSourceLibrary(int index) const;
     
+    // Library of the root folder holding the file, or the one detected from its notes
+    // when the folder's library is Unknown
+    DrumLibrary getSourceLibraryFor(const juce::File& file) const;
+    
     // UPDATED: Made const for use in const contexts
     uint8_t mapNoteToLibrary(uint8_t note, DrumLibrary from, DrumLibrary to) const;
+    
+    // 128-entry lookup table of mapNoteToLibrary for a library pair, built on first use
+    using NoteMap = std::array<uint8_t, 128>;
+    const NoteMap& getNoteMap(DrumLibrary from, DrumLibrary to) const;
 	
 	static juce::String getLibraryName(DrumLibrary library);
     static juce::StringArray getAllLibraryNames();
@@ -56,6 +82,9 @@ public:
 	// Target library persistence
 	void setLastSelectedTargetLibrary(DrumLibrary library);
 	DrumLibrary getLastSelectedTargetLibrary() const;
+    
+    // Memory the dissection cache may use, from config.xml
+    size_t getCacheMemoryLimit() const { return cacheMemoryLimit; }
 private:
     struct FolderInfo
     {
@@ -63,14 +92,30 @@ private:
         DrumLibrary sourceLibrary;
     };
     
+    // Written on the message thread only; readers on other threads take the lock
     std::vector<FolderInfo> rootFolders;
+    juce::CriticalSection rootFolderLock;
     juce::File getConfigFile() const;
+    void updateWatchedFolders();
 	
 	DrumLibrary lastSelectedTargetLibrary = DrumLibrary::GeneralMIDI;
+    size_t cacheMemoryLimit = 64 * 1024 * 1024;
     
     // Note mapping tables - using nested maps instead of 3D vector
     void initializeMappingTables();
     std::map<int, std::map<int, std::map<uint8_t, uint8_t>>> mappings;
     
+    // Memoised note maps keyed by (from << 8) | to
+    mutable std::map<int, NoteMap> noteMaps;
+    juce::CriticalSection noteMapLock;
+    
+    // Built from the mapping tables; read by index scans
+    std::unique_ptr<SourceLibraryDetector> sourceLibraryDetector;
+    
+    // Declared last so a running scan is stopped before anything it reads is destroyed
+    std::unique_ptr<GrooveLibraryIndex> libraryIndex;
+    std::unique_ptr<GrooveSearchIndex> searchIndex;     // Listens to libraryIndex
+    std::unique_ptr<GrooveThumbnailCache> thumbnailCache;   // Listens to libraryIndex
+    
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DrumLibraryManager)
 };
\ No newline at end of file
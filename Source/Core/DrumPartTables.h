@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <initializer_list>
+#include "MidiDissector.h"
+
+/**
+ * Compile-time note -> DrumPartType tables.
+ *
+ * Every library starts from the General MIDI table and only lists the notes it assigns
+ * differently. To support a new library, add an override list and return it from getPartTable().
+ */
+namespace DrumPartTables
+{
+    using PartTable = std::array<DrumPartType, 128>;
+
+    struct NoteAssignment
+    {
+        uint8_t note;
+        DrumPartType type;
+    };
+
+    constexpr PartTable makePartTable(const PartTable& base, std::initializer_list<NoteAssignment> assignments)
+    {
+        PartTable table = base;
+        for (const auto& assignment : assignments)
+            table[assignment.note & 0x7f] = assignment.type;
+        return table;
+    }
+
+    constexpr PartTable makeEmptyTable()
+    {
+        PartTable table {};
+        for (auto& type : table)
+            type = DrumPartType::Other;
+        return table;
+    }
+
+    inline constexpr PartTable generalMidi = makePartTable(makeEmptyTable(), {
+        // Kicks
+        { 35, DrumPartType::Kick }, { 36, DrumPartType::Kick },
+        // Snares
+        { 38, DrumPartType::Snare }, { 40, DrumPartType::Snare },
+        // Hi-hats
+        { 42, DrumPartType::HiHatClosed }, { 44, DrumPartType::HiHatClosed },
+        { 46, DrumPartType::HiHatOpen },
+        // Cymbals
+        { 49, DrumPartType::Crash }, { 57, DrumPartType::Crash },
+        { 51, DrumPartType::Ride }, { 59, DrumPartType::Ride },
+        // Toms
+        { 45, DrumPartType::Tom1 }, { 47, DrumPartType::Tom1 },
+        { 48, DrumPartType::Tom2 }, { 50, DrumPartType::Tom2 },
+        { 41, DrumPartType::FloorTom }, { 43, DrumPartType::FloorTom },
+        // Percussion
+        { 39, DrumPartType::Clap },
+        { 56, DrumPartType::Cowbell },
+        { 69, DrumPartType::Shaker }, { 70, DrumPartType::Shaker }
+    });
+
+    inline constexpr PartTable ugritone = makePartTable(generalMidi, {
+        { 37, DrumPartType::Snare },
+        // Hi-hats - Ugritone custom notes
+        { 22, DrumPartType::HiHatClosed },
+        { 26, DrumPartType::HiHatOpen },
+        // Cymbals
+        { 52, DrumPartType::Crash }, { 55, DrumPartType::Crash },
+        { 53, DrumPartType::Ride },
+        // Percussion
+        { 54, DrumPartType::Shaker }, { 58, DrumPartType::Shaker }
+    });
+
+    inline constexpr PartTable ezdrummer = makePartTable(generalMidi, {
+        { 24, DrumPartType::Kick },
+        { 26, DrumPartType::Snare }
+    });
+
+    constexpr const PartTable& getPartTable(DrumLibrary library)
+    {
+        switch (library)
+        {
+            case DrumLibrary::Ugritone:  return ugritone;
+            case DrumLibrary::EZdrummer: return ezdrummer;
+            default:                     return generalMidi;
+        }
+    }
+
+    static_assert(generalMidi[36] == DrumPartType::Kick && generalMidi[60] == DrumPartType::Other);
+    static_assert(ugritone[22] == DrumPartType::HiHatClosed && ezdrummer[24] == DrumPartType::Kick);
+}
@@ -1,4 +1,5 @@
 #include "FavoritesManager.h"
+#include <algorithm>
 
 FavoritesManager::FavoritesManager()
 {
@@ -7,7 +8,10 @@ FavoritesManager::FavoritesManager()
 
 FavoritesManager::~FavoritesManager()
 {
-    save();
+    stopTimer();
+    
+    if (isDirty)
+        save();
 }
 
 void FavoritesManager::addFavorite(const juce::File& folder, const juce::String& customName)
@@ -20,7 +24,7 @@ void FavoritesManager::addFavorite(const juce::File& folder, const juce::String&
     
     juce::String name = customName.isEmpty() ? folder.getFileName() : customName;
     favorites.add(Favorite(name, folder));
-    save();
+    scheduleSave();
 }
 
 void FavoritesManager::removeFavorite(const juce::String& id)
@@ -30,7 +34,7 @@ void FavoritesManager::removeFavorite(const juce::String& id)
         if (favorites[i].id == id)
         {
             favorites.remove(i);
-            save();
+            scheduleSave();
             return;
         }
     }
@@ -43,7 +47,7 @@ void FavoritesManager::renameFavorite(const juce::String& id, const juce::String
         if (fav.id == id)
         {
             fav.name = newName;
-            save();
+            scheduleSave();
             return;
         }
     }
@@ -87,6 +91,193 @@ bool FavoritesManager::isFavorite(const juce::File& folder) const
     return false;
 }
 
+void FavoritesManager::setFileFavorite(const juce::File& file, bool shouldBeFavorite)
+{
+    const auto marks = getFileMarks(file);
+    setFileMarks(file, shouldBeFavorite ? (marks | favoriteMark) : (marks & ~favoriteMark));
+}
+
+bool FavoritesManager::isFileFavorite(const juce::File& file) const
+{
+    return (getFileMarks(file) & favoriteMark) != 0;
+}
+
+void FavoritesManager::setFileTag(const juce::File& file, const juce::String& tag, bool shouldHaveTag)
+{
+    // Tags are stored comma separated
+    const auto name = tag.replaceCharacter(',', ' ').trim();
+    if (name.isEmpty())
+        return;
+    
+    int index = getTagIndex(name);
+    
+    if (index < 0)
+    {
+        if (!shouldHaveTag)
+            return;
+        
+        if (tagNames.size() >= maxTags)
+        {
+            DBG("FavoritesManager: Too many tags, not adding '" + name + "'");
+            return;
+        }
+        
+        tagNames.add(name);
+        index = tagNames.size() - 1;
+    }
+    
+    const Marks bit = static_cast<Marks>(1) << (index + 1);
+    const auto marks = getFileMarks(file);
+    setFileMarks(file, shouldHaveTag ? (marks | bit) : (marks & ~bit));
+}
+
+juce::StringArray FavoritesManager::getFileTags(const juce::File& file) const
+{
+    const auto marks = getFileMarks(file);
+    juce::StringArray tags;
+    
+    for (int i = 0; i < tagNames.size(); ++i)
+        if ((marks >> (i + 1)) & 1u)
+            tags.add(tagNames[i]);
+    
+    return tags;
+}
+
+void FavoritesManager::setFileMarks(const juce::File& file, Marks marks)
+{
+    const auto path = file.getFullPathName();
+    
+    if (marks == 0)
+        fileMarks.erase(path);
+    else
+        fileMarks[path] = marks;
+    
+    // Only this file's row needs updating in the evaluation state
+    if (evaluatedSnapshot != nullptr)
+    {
+        const int row = evaluatedSnapshot->indexOf(file);
+        if (row >= 0)
+            rowMarks[static_cast<size_t>(row)] = marks;
+    }
+    
+    scheduleSave();
+}
+
+FavoritesManager::Marks FavoritesManager::getFileMarks(const juce::File& file) const
+{
+    const auto found = fileMarks.find(file.getFullPathName());
+    return found != fileMarks.end() ? found->second : 0;
+}
+
+int FavoritesManager::getTagIndex(const juce::String& tag) const
+{
+    return tagNames.indexOf(tag, true);
+}
+
+juce::String FavoritesManager::addSmartCollection(const SmartCollection& collection)
+{
+    auto& added = collections.emplace_back(collection);
+    added.id = juce::Uuid().toString();
+    
+    scheduleSave();
+    return added.id;
+}
+
+void FavoritesManager::removeSmartCollection(const juce::String& id)
+{
+    const auto found = std::find_if(collections.begin(), collections.end(),
+                                    [&id](const SmartCollection& c) { return c.id == id; });
+    if (found == collections.end())
+        return;
+    
+    filterMatches.erase(id);
+    collections.erase(found);
+    scheduleSave();
+}
+
+void FavoritesManager::renameSmartCollection(const juce::String& id, const juce::String& newName)
+{
+    for (auto& collection : collections)
+    {
+        if (collection.id == id)
+        {
+            collection.name = newName;
+            scheduleSave();
+            return;
+        }
+    }
+}
+
+std::vector<int> FavoritesManager::getCollectionRows(const juce::String& id, const GrooveLibraryIndex::Snapshot::Ptr& snapshot)
+{
+    const auto found = std::find_if(collections.begin(), collections.end(),
+                                    [&id](const SmartCollection& c) { return c.id == id; });
+    if (found == collections.end() || snapshot == nullptr)
+        return {};
+    
+    const auto& collection = *found;
+    
+    Marks required = collection.favoritesOnly ? favoriteMark : 0;
+    for (const auto& tag : collection.tags)
+    {
+        const int index = getTagIndex(tag);
+        if (index < 0)
+            return {};   // No file has it
+        
+        required |= static_cast<Marks>(1) << (index + 1);
+    }
+    
+    const auto& marks = getRowMarks(snapshot);
+    
+    auto& matches = filterMatches[collection.id];
+    if (matches.empty() && snapshot->size() > 0)
+        matches = collection.filter.isActive() ? snapshot->filter(collection.filter)
+                                               : std::vector<juce::uint8>(static_cast<size_t>(snapshot->size()), 1);
+    
+    std::vector<int> rows;
+    for (size_t row = 0; row < matches.size(); ++row)
+    {
+        if (matches[row] != 0 && (marks[row] & required) == required)
+            rows.push_back(static_cast<int>(row));
+    }
+    
+    return rows;
+}
+
+const std::vector<FavoritesManager::Marks>& FavoritesManager::getRowMarks(const GrooveLibraryIndex::Snapshot::Ptr& snapshot)
+{
+    if (snapshot == evaluatedSnapshot)
+        return rowMarks;
+    
+    // A new snapshot: filters are evaluated again as collections are listed
+    evaluatedSnapshot = snapshot;
+    filterMatches.clear();
+    rowMarks.assign(static_cast<size_t>(snapshot->size()), 0);
+    
+    for (const auto& [path, marks] : fileMarks)
+    {
+        const int row = snapshot->indexOf(juce::File(path));
+        if (row >= 0)
+            rowMarks[static_cast<size_t>(row)] = marks;
+    }
+    
+    return rowMarks;
+}
+
+void FavoritesManager::scheduleSave()
+{
+    // Batches the writes of a burst of changes into one
+    isDirty = true;
+    startTimer(saveDelayMs);
+    sendChangeMessage();
+}
+
+void FavoritesManager::timerCallback()
+{
+    stopTimer();
+    save();
+}
+
 void FavoritesManager::save()
 {
     auto file = getFavoritesFile();
@@ -101,7 +292,38 @@ void FavoritesManager::save()
         favXml->setAttribute("path", fav.path.getFullPathName());
     }
     
-    xml.writeTo(file);
+    for (const auto& collection : collections)
+    {
+        const auto& filter = collection.filter;
+        auto* collectionXml = xml.createNewChildElement("Collection");
+        collectionXml->setAttribute("id", collection.id);
+        collectionXml->setAttribute("name", collection.name);
+        collectionXml->setAttribute("tags", collection.tags.joinIntoString(","));
+        collectionXml->setAttribute("favoritesOnly", collection.favoritesOnly);
+        collectionXml->setAttribute("minBpm", filter.minBpm);
+        collectionXml->setAttribute("maxBpm", filter.maxBpm);
+        collectionXml->setAttribute("minBars", filter.minBars);
+        collectionXml->setAttribute("maxBars", filter.maxBars);
+        collectionXml->setAttribute("numerator", filter.timeSignatureNumerator);
+        collectionXml->setAttribute("denominator", filter.timeSignatureDenominator);
+        collectionXml->setAttribute("requiredParts", static_cast<int>(filter.requiredParts));
+        collectionXml->setAttribute("excludedParts", static_cast<int>(filter.excludedParts));
+        collectionXml->setAttribute("fills", filter.fills);
+        collectionXml->setAttribute("doubleKick", filter.doubleKick);
+    }
+    
+    for (const auto& [path, marks] : fileMarks)
+    {
+        auto* fileXml = xml.createNewChildElement("File");
+        fileXml->setAttribute("path", path);
+        fileXml->setAttribute("favorite", (marks & favoriteMark) != 0);
+        fileXml->setAttribute("tags", getFileTags(juce::File(path)).joinIntoString(","));
+    }
+    
+    if (!xml.writeTo(file))
+        DBG("FavoritesManager: Failed to write " + file.getFullPathName());
+    
+    isDirty = false;
 }
 
 void FavoritesManager::load()
@@ -116,6 +338,10 @@ void FavoritesManager::load()
         return;
     
     favorites.clear();
+    collections.clear();
+    fileMarks.clear();
+    tagNames.clear();
+    evaluatedSnapshot = nullptr;
     
     for (auto* favXml : xml->getChildIterator())
     {
@@ -129,6 +355,54 @@ void FavoritesManager::load()
             if (fav.path.exists())
                 favorites.add(fav);
         }
+        else if (favXml->hasTagName("Collection"))
+        {
+            SmartCollection collection;
+            collection.id = favXml->getStringAttribute("id");
+            collection.name = favXml->getStringAttribute("name");
+            collection.tags.addTokens(favXml->getStringAttribute("tags"), ",", "");
+            collection.tags.removeEmptyStrings();
+            collection.favoritesOnly = favXml->getBoolAttribute("favoritesOnly");
+            
+            auto& filter = collection.filter;
+            filter.minBpm = favXml->getDoubleAttribute("minBpm");
+            filter.maxBpm = favXml->getDoubleAttribute("maxBpm");
+            filter.minBars = favXml->getIntAttribute("minBars");
+            filter.maxBars = favXml->getIntAttribute("maxBars");
+            filter.timeSignatureNumerator = favXml->getIntAttribute("numerator");
+            filter.timeSignatureDenominator = favXml->getIntAttribute("denominator");
+            filter.requiredParts = static_cast<juce::uint16>(favXml->getIntAttribute("requiredParts"));
+            filter.excludedParts = static_cast<juce::uint16>(favXml->getIntAttribute("excludedParts"));
+            filter.fills = favXml->getIntAttribute("fills");
+            filter.doubleKick = favXml->getBoolAttribute("doubleKick");
+            
+            collections.push_back(collection);
+        }
+        else if (favXml->hasTagName("File"))
+        {
+            const juce::File file(favXml->getStringAttribute("path"));
+            
+            juce::StringArray tags;
+            tags.addTokens(favXml->getStringAttribute("tags"), ",", "");
+            tags.removeEmptyStrings();
+            
+            Marks marks = favXml->getBoolAttribute("favorite") ? favoriteMark : 0;
+            for (const auto& tag : tags)
+            {
+                int index = getTagIndex(tag);
+                if (index < 0 && tagNames.size() < maxTags)
+                {
+                    tagNames.add(tag);
+                    index = tagNames.size() - 1;
+                }
+                
+                if (index >= 0)
+                    marks |= static_cast<Marks>(1) << (index + 1);
+            }
+            
+            if (marks != 0)
+                fileMarks[file.getFullPathName()] = marks;
+        }
     }
 }
 
@@ -2,6 +2,9 @@
 
 #include <juce_core/juce_core.h>
 #include <juce_data_structures/juce_data_structures.h>
+#include <map>
+#include <vector>
+#include "GrooveLibraryIndex.h"
 
 struct Favorite
 {
@@ -14,7 +17,20 @@ struct Favorite
         : name(n), path(p), id(juce::Uuid().toString()) {}
 };
 
-class FavoritesManager
+// A saved query over the library index, listed like a favorite folder
+struct SmartCollection
+{
+    juce::String id;
+    juce::String name;
+    GrooveFilter filter;
+    juce::StringArray tags;        // Every one must be set on the file
+    bool favoritesOnly = false;
+};
+
+// Folder favorites, per-file favorites and tags, and smart collections.
+// Changes are written to disk together, a moment after the last one.
+class FavoritesManager : public juce::ChangeBroadcaster,
+                         private juce::Timer
 {
 public:
     FavoritesManager();
@@ -31,10 +47,53 @@ public:
     juce::String getFavoriteId(int index) const;
     bool isFavorite(const juce::File& folder) const;
     
+    // Per-file marks, keyed by path
+    void setFileFavorite(const juce::File& file, bool shouldBeFavorite);
+    bool isFileFavorite(const juce::File& file) const;
+    void setFileTag(const juce::File& file, const juce::String& tag, bool shouldHaveTag);
+    juce::StringArray getFileTags(const juce::File& file) const;
+    const juce::StringArray& getAllTags() const { return tagNames; }
+    
+    juce::String addSmartCollection(const SmartCollection& collection);
+    void removeSmartCollection(const juce::String& id);
+    void renameSmartCollection(const juce::String& id, const juce::String& newName);
+    int getNumSmartCollections() const { return static_cast<int>(collections.size()); }
+    const SmartCollection& getSmartCollection(int index) const { return collections[static_cast<size_t>(index)]; }
+    
+    // Index rows in a collection. The filter is evaluated once per snapshot and
+    // mark changes only touch the row of the file that changed.
+    std::vector<int> getCollectionRows(const juce::String& id, const GrooveLibraryIndex::Snapshot::Ptr& snapshot);
+    
     void save();
     void load();
     
 private:
+    using Marks = juce::uint64;                       // Bit 0 = favorite, bit n + 1 = tagNames[n]
+    static constexpr Marks favoriteMark = 1;
+    static constexpr int maxTags = 63;
+    static constexpr int saveDelayMs = 1000;
+    
+    void timerCallback() override;
+    void scheduleSave();
+    
+    void setFileMarks(const juce::File& file, Marks marks);
+    Marks getFileMarks(const juce::File& file) const;
+    int getTagIndex(const juce::String& tag) const;
+    
+    const std::vector<Marks>& getRowMarks(const GrooveLibraryIndex::Snapshot::Ptr& snapshot);
+    
     juce::Array<Favorite> favorites;
+    std::vector<SmartCollection> collections;
+    std::map<juce::String, Marks> fileMarks;         // Full path -> marks
+    juce::StringArray tagNames;
+    bool isDirty = false;
+    
+    // Evaluation state for the last snapshot a collection was listed against
+    GrooveLibraryIndex::Snapshot::Ptr evaluatedSnapshot;
+    std::vector<Marks> rowMarks;
+    std::map<juce::String, std::vector<juce::uint8>> filterMatches;   // Collection id -> matches
+    
     juce::File getFavoritesFile() const;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FavoritesManager)
 };
\ No newline at end of file
@@ -0,0 +1,1877 @@
+#include "GrooveLibraryIndex.h"
+#include "MidiDissector.h"
+#include "SourceLibraryDetector.h"
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <limits>
+#include <unordered_set>
+
+#if JUCE_LINUX
+ #include <sys/inotify.h>
+ #include <poll.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr juce::uint32 indexMagic = 0x494c4744;   // "DGLI" read in native (little endian) order
+    constexpr juce::uint32 indexVersion = 10;
+    constexpr size_t maxScanErrors = 1000;         // Kept for the dialog; failedFiles counts them all
+
+    bool isInsideRoot(const juce::String& path, const juce::File& root)
+    {
+        return path.startsWith(root.getFullPathName() + juce::File::getSeparatorString());
+    }
+
+    bool isMidiFile(const juce::File& file)
+    {
+        return file.hasFileExtension("mid;midi");
+    }
+
+    // Byte-wise UTF-8 ordering, the order rows are stored in
+    int comparePaths(const char* a, size_t aLength, const char* b, size_t bLength)
+    {
+        const int result = std::memcmp(a, b, juce::jmin(aLength, bLength));
+        if (result != 0)
+            return result;
+        return aLength < bLength ? -1 : (aLength > bLength ? 1 : 0);
+    }
+
+    bool pathLess(const juce::String& a, const juce::String& b)
+    {
+        return comparePaths(a.toRawUTF8(), a.getNumBytesAsUTF8(), b.toRawUTF8(), b.getNumBytesAsUTF8()) < 0;
+    }
+
+    juce::uint64 alignTo8(juce::uint64 offset)
+    {
+        return (offset + 7) & ~static_cast<juce::uint64>(7);
+    }
+}
+
+//==============================================================================
+// On-disk layout. All offsets are from the start of the file and 8-byte aligned.
+struct GrooveLibraryIndex::Snapshot::Header
+{
+    juce::uint32 magic;
+    juce::uint32 version;
+    juce::uint32 numEntries;
+    juce::uint32 featuresSize;          // sizeof(RhythmFeatures) when written
+    juce::uint64 totalSize;
+
+    juce::uint64 pathOffsets;           // uint32[numEntries + 1] into the string table
+    juce::uint64 strings;               // UTF-8 paths, not terminated
+    juce::uint64 stringsSize;
+
+    juce::uint64 fileSizes;             // int64[numEntries]
+    juce::uint64 modificationTimes;     // int64[numEntries], ms since epoch
+    juce::uint64 bpms;                  // float[numEntries]
+    juce::uint64 durations;             // float[numEntries], seconds
+    juce::uint64 ticksPerQuarter;       // uint16[numEntries]
+    juce::uint64 barCounts;             // uint16[numEntries]
+    juce::uint64 timeSignatures;        // uint16[numEntries], numerator << 8 | denominator
+    juce::uint64 timeSignatureFlags;    // uint8[numEntries], 1 = detected from the onsets
+    juce::uint64 fillBars;              // uint64[numEntries]
+    juce::uint64 partsMasks;            // uint16[numEntries]
+    juce::uint64 sourceLibraries;       // uint8[numEntries]
+    juce::uint64 features;              // RhythmFeatures[numEntries]
+    juce::uint64 fingerprints;          // GrooveFingerprint[numEntries]
+    juce::uint64 contentHashes;         // uint64[numEntries]
+    juce::uint64 onsetHashes;           // uint64[numEntries]
+    juce::uint64 detectedLibraries;     // uint8[numEntries]
+    juce::uint64 noteMasks;             // uint64[2 * numEntries]
+
+    juce::uint64 numDirectories;
+    juce::uint64 directoryPathOffsets;  // uint32[numDirectories + 1] into the directory string table
+    juce::uint64 directoryStrings;
+    juce::uint64 directoryStringsSize;
+    juce::uint64 directoryModificationTimes;   // int64[numDirectories]
+};
+
+// Sorted path column: offsets into a block of concatenated UTF-8 strings
+struct GrooveLibraryIndex::Snapshot::PathTable
+{
+    const juce::uint32* offsets = nullptr;
+    const char* strings = nullptr;
+    juce::uint64 stringsSize = 0;
+    int count = 0;
+
+    const char* get(int row, size_t& length) const noexcept
+    {
+        const juce::uint32 start = offsets[row];
+        const juce::uint32 end = offsets[row + 1];
+
+        if (end < start || end > stringsSize)
+        {
+            length = 0;
+            return strings;
+        }
+
+        length = end - start;
+        return strings + start;
+    }
+
+    juce::String getString(int row) const
+    {
+        size_t length = 0;
+        const char* text = get(row, length);
+        return juce::String::fromUTF8(text, static_cast<int>(length));
+    }
+
+    int find(const juce::String& path) const
+    {
+        const char* target = path.toRawUTF8();
+        const size_t targetLength = path.getNumBytesAsUTF8();
+
+        int low = 0;
+        int high = count - 1;
+
+        while (low <= high)
+        {
+            const int mid = low + (high - low) / 2;
+            size_t length = 0;
+            const char* text = get(mid, length);
+            const int result = comparePaths(text, length, target, targetLength);
+
+            if (result == 0)
+                return mid;
+            if (result < 0)
+                low = mid + 1;
+            else
+                high = mid - 1;
+        }
+
+        return -1;
+    }
+
+    // Rows whose path starts with prefix form one contiguous range [first, second)
+    std::pair<int, int> findPrefixRange(const juce::String& prefix) const
+    {
+        const char* target = prefix.toRawUTF8();
+        const size_t targetLength = prefix.getNumBytesAsUTF8();
+
+        auto comparePrefix = [&](int row)
+        {
+            size_t length = 0;
+            const char* text = get(row, length);
+            const int result = std::memcmp(text, target, juce::jmin(length, targetLength));
+            if (result != 0)
+                return result;
+            return length < targetLength ? -1 : 0;
+        };
+
+        int low = 0, high = count;
+        while (low < high)
+        {
+            const int mid = low + (high - low) / 2;
+            if (comparePrefix(mid) < 0) low = mid + 1; else high = mid;
+        }
+
+        const int first = low;
+        high = count;
+        while (low < high)
+        {
+            const int mid = low + (high - low) / 2;
+            if (comparePrefix(mid) <= 0) low = mid + 1; else high = mid;
+        }
+
+        return { first, low };
+    }
+
+    // Rows directly inside a directory, i.e. with no further separator after the prefix
+    template <typename Callback>
+    void forEachDirectChild(const juce::File& directory, Callback&& callback) const
+    {
+        const juce::String prefix = directory.getFullPathName() + juce::File::getSeparatorString();
+        const size_t prefixLength = prefix.getNumBytesAsUTF8();
+        const char separator = static_cast<char>(juce::File::getSeparatorChar());
+        const auto range = findPrefixRange(prefix);
+
+        for (int row = range.first; row < range.second; ++row)
+        {
+            size_t length = 0;
+            const char* text = get(row, length);
+
+            if (std::memchr(text + prefixLength, separator, length - prefixLength) == nullptr)
+                callback(row);
+        }
+    }
+};
+
+namespace
+{
+    // Hashes the note-ons of a groove in a canonical form: General MIDI notes,
+    // times rescaled to 480 ticks per quarter, sorted. Copies of a groove that
+    // use another library's note map or file resolution hash the same.
+    void hashCanonicalEvents(const juce::Array<DrumPart>& parts, int ticksPerQuarterNote,
+                             const DrumLibraryManager::NoteMap& toGeneralMidi,
+                             juce::uint64& contentHash, juce::uint64& onsetHash)
+    {
+        struct CanonicalEvent
+        {
+            juce::int64 tick;
+            juce::uint8 note;
+            juce::uint8 velocity;
+        };
+
+        std::vector<CanonicalEvent> events;
+        const double tickScale = 480.0 / juce::jmax(1, ticksPerQuarterNote);
+
+        for (const auto& part : parts)
+        {
+            for (const auto* event : part.getSequence())
+            {
+                const auto& message = event->message;
+                if (message.isNoteOn())
+                    events.push_back({ juce::roundToInt(message.getTimeStamp() * tickScale),
+                                       toGeneralMidi[static_cast<size_t>(message.getNoteNumber())],
+                                       message.getVelocity() });
+            }
+        }
+
+        contentHash = 0;
+        onsetHash = 0;
+
+        if (events.empty())
+            return;
+
+        std::sort(events.begin(), events.end(), [](const CanonicalEvent& a, const CanonicalEvent& b)
+        {
+            return a.tick != b.tick ? a.tick < b.tick
+                 : a.note != b.note ? a.note < b.note
+                                    : a.velocity < b.velocity;
+        });
+
+        // FNV-1a, 64 bit
+        juce::uint64 content = 14695981039346656037ULL;
+        juce::uint64 onsets = 14695981039346656037ULL;
+        auto mix = [](juce::uint64& hash, juce::uint64 value, int bytes)
+        {
+            for (int i = 0; i < bytes; ++i)
+            {
+                hash ^= (value >> (i * 8)) & 0xff;
+                hash *= 1099511628211ULL;
+            }
+        };
+
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            const auto& event = events[i];
+            mix(content, static_cast<juce::uint64>(event.tick), 8);
+            mix(content, event.note, 1);
+            mix(content, event.velocity, 1);
+
+            // Doubled hits that only differed in velocity count once
+            if (i > 0 && events[i - 1].tick == event.tick && events[i - 1].note == event.note)
+                continue;
+
+            mix(onsets, static_cast<juce::uint64>(event.tick), 8);
+            mix(onsets, event.note, 1);
+        }
+
+        // 0 is reserved for grooves without notes
+        contentHash = content != 0 ? content : 1;
+        onsetHash = onsets != 0 ? onsets : 1;
+    }
+
+    // Appends a sorted path table to the layout and returns { offsetsOffset, stringsOffset, stringsSize }
+    struct PathTableLayout
+    {
+        juce::uint64 offsets = 0;
+        juce::uint64 strings = 0;
+        juce::uint64 stringsSize = 0;
+    };
+
+    template <typename Rows>
+    juce::uint64 totalPathBytes(const Rows& rows)
+    {
+        juce::uint64 bytes = 0;
+        for (const auto& row : rows)
+            bytes += row.path.getNumBytesAsUTF8();
+        return bytes;
+    }
+
+    template <typename Rows>
+    void writePathTable(char* data, const PathTableLayout& layout, const Rows& rows)
+    {
+        auto* offsets = reinterpret_cast<juce::uint32*>(data + layout.offsets);
+        juce::uint32 position = 0;
+
+        for (size_t i = 0; i < rows.size(); ++i)
+        {
+            const size_t bytes = rows[i].path.getNumBytesAsUTF8();
+            offsets[i] = position;
+            std::memcpy(data + layout.strings + position, rows[i].path.toRawUTF8(), bytes);
+            position += static_cast<juce::uint32>(bytes);
+        }
+
+        offsets[rows.size()] = position;
+    }
+}
+
+GrooveLibraryIndex::Snapshot::Ptr GrooveLibraryIndex::Snapshot::createEmpty()
+{
+    return createFromEntries({}, {});
+}
+
+GrooveLibraryIndex::Snapshot::Ptr GrooveLibraryIndex::Snapshot::createFromEntries(std::vector<GrooveIndexEntry> entries,
+                                                                                std::vector<GrooveIndexDirectory> directories)
+{
+    std::sort(entries.begin(), entries.end(), [](const GrooveIndexEntry& a, const GrooveIndexEntry& b)
+    {
+        return pathLess(a.path, b.path);
+    });
+
+    std::sort(directories.begin(), directories.end(), [](const GrooveIndexDirectory& a, const GrooveIndexDirectory& b)
+    {
+        return pathLess(a.path, b.path);
+    });
+
+    const auto n = static_cast<juce::uint64>(entries.size());
+    const auto numDirectories = static_cast<juce::uint64>(directories.size());
+
+    Header header {};
+    header.magic = indexMagic;
+    header.version = indexVersion;
+    header.numEntries = static_cast<juce::uint32>(n);
+    header.featuresSize = sizeof(RhythmFeatures);
+    header.numDirectories = numDirectories;
+
+    juce::uint64 offset = alignTo8(sizeof(Header));
+    auto place = [&offset](juce::uint64 bytes)
+    {
+        const juce::uint64 start = offset;
+        offset = alignTo8(offset + bytes);
+        return start;
+    };
+
+    header.stringsSize       = totalPathBytes(entries);
+    header.pathOffsets       = place((n + 1) * sizeof(juce::uint32));
+    header.strings           = place(header.stringsSize);
+    header.fileSizes         = place(n * sizeof(juce::int64));
+    header.modificationTimes = place(n * sizeof(juce::int64));
+    header.bpms              = place(n * sizeof(float));
+    header.durations         = place(n * sizeof(float));
+    header.ticksPerQuarter   = place(n * sizeof(juce::uint16));
+    header.barCounts         = place(n * sizeof(juce::uint16));
+    header.timeSignatures    = place(n * sizeof(juce::uint16));
+    header.timeSignatureFlags = place(n * sizeof(juce::uint8));
+    header.fillBars          = place(n * sizeof(juce::uint64));
+    header.partsMasks        = place(n * sizeof(juce::uint16));
+    header.sourceLibraries   = place(n * sizeof(juce::uint8));
+    header.features          = place(n * sizeof(RhythmFeatures));
+    header.fingerprints      = place(n * sizeof(GrooveFingerprint));
+    header.contentHashes     = place(n * sizeof(juce::uint64));
+    header.onsetHashes       = place(n * sizeof(juce::uint64));
+    header.detectedLibraries = place(n * sizeof(juce::uint8));
+    header.noteMasks         = place(n * 2 * sizeof(juce::uint64));
+
+    header.directoryStringsSize       = totalPathBytes(directories);
+    header.directoryPathOffsets       = place((numDirectories + 1) * sizeof(juce::uint32));
+    header.directoryStrings           = place(header.directoryStringsSize);
+    header.directoryModificationTimes = place(numDirectories * sizeof(juce::int64));
+    header.totalSize                  = offset;
+
+    Ptr snapshot = new Snapshot();
+    snapshot->ownedData.setSize(static_cast<size_t>(header.totalSize), true);
+
+    auto* data = static_cast<char*>(snapshot->ownedData.getData());
+    std::memcpy(data, &header, sizeof(Header));
+
+    writePathTable(data, { header.pathOffsets, header.strings, header.stringsSize }, entries);
+    writePathTable(data, { header.directoryPathOffsets, header.directoryStrings, header.directoryStringsSize }, directories);
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const auto& entry = entries[i];
+
+        reinterpret_cast<juce::int64*>(data + header.fileSizes)[i] = entry.fileSize;
+        reinterpret_cast<juce::int64*>(data + header.modificationTimes)[i] = entry.modificationTime;
+        reinterpret_cast<float*>(data + header.bpms)[i] = static_cast<float>(entry.bpm);
+        reinterpret_cast<float*>(data + header.durations)[i] = static_cast<float>(entry.durationSeconds);
+        reinterpret_cast<juce::uint16*>(data + header.ticksPerQuarter)[i] = static_cast<juce::uint16>(entry.ticksPerQuarterNote);
+        reinterpret_cast<juce::uint16*>(data + header.barCounts)[i] = static_cast<juce::uint16>(juce::jlimit(0, 0xffff, entry.barCount));
+        reinterpret_cast<juce::uint16*>(data + header.timeSignatures)[i] =
+            static_cast<juce::uint16>((entry.timeSignatureNumerator << 8) | entry.timeSignatureDenominator);
+        reinterpret_cast<juce::uint8*>(data + header.timeSignatureFlags)[i] = entry.timeSignatureDetected ? 1 : 0;
+        reinterpret_cast<juce::uint64*>(data + header.fillBars)[i] = entry.fillBars;
+        reinterpret_cast<juce::uint16*>(data + header.partsMasks)[i] = entry.partsMask;
+        reinterpret_cast<juce::uint8*>(data + header.sourceLibraries)[i] = static_cast<juce::uint8>(entry.sourceLibrary);
+        reinterpret_cast<RhythmFeatures*>(data + header.features)[i] = entry.features;
+        reinterpret_cast<GrooveFingerprint*>(data + header.fingerprints)[i] = entry.fingerprint;
+        reinterpret_cast<juce::uint64*>(data + header.contentHashes)[i] = entry.contentHash;
+        reinterpret_cast<juce::uint64*>(data + header.onsetHashes)[i] = entry.onsetHash;
+        reinterpret_cast<juce::uint8*>(data + header.detectedLibraries)[i] = static_cast<juce::uint8>(entry.detectedLibrary);
+        reinterpret_cast<std::array<juce::uint64, 2>*>(data + header.noteMasks)[i] = entry.noteMask;
+    }
+
+    for (size_t i = 0; i < directories.size(); ++i)
+        reinterpret_cast<juce::int64*>(data + header.directoryModificationTimes)[i] = directories[i].modificationTime;
+
+    snapshot->attach(data, snapshot->ownedData.getSize());
+    return snapshot;
+}
+
+GrooveLibraryIndex::Snapshot::Ptr GrooveLibraryIndex::Snapshot::createFromFile(const juce::File& indexFile)
+{
+    if (!indexFile.existsAsFile())
+        return nullptr;
+
+    Ptr snapshot = new Snapshot();
+    snapshot->mappedFile = std::make_unique<juce::MemoryMappedFile>(indexFile, juce::MemoryMappedFile::readOnly);
+
+    if (snapshot->mappedFile->getData() == nullptr
+        || !snapshot->attach(snapshot->mappedFile->getData(), snapshot->mappedFile->getSize()))
+    {
+        DBG("GrooveLibraryIndex: Ignoring unreadable or outdated index " + indexFile.getFullPathName());
+        return nullptr;
+    }
+
+    return snapshot;
+}
+
+bool GrooveLibraryIndex::Snapshot::attach(const void* data, size_t dataSize)
+{
+    if (dataSize < sizeof(Header))
+        return false;
+
+    const auto* h = static_cast<const Header*>(data);
+
+    if (h->magic != indexMagic || h->version != indexVersion
+        || h->featuresSize != sizeof(RhythmFeatures) || h->totalSize > dataSize)
+        return false;
+
+    // Every column must lie inside the file. Counts come from the file, so nothing here may wrap.
+    const juce::uint64 n = h->numEntries;
+    const juce::uint64 numDirectories = h->numDirectories;
+    const juce::uint64 totalSize = h->totalSize;
+
+    auto fits = [totalSize](juce::uint64 offset, juce::uint64 count, juce::uint64 elementSize)
+    {
+        if ((offset & 7) != 0 || offset < sizeof(Header) || offset > totalSize)
+            return false;
+
+        const juce::uint64 available = totalSize - offset;
+        return count <= available / elementSize;   // count * elementSize <= available, without the multiplication
+    };
+
+    // Rows are addressed with ints
+    constexpr juce::uint64 maxRows = 0x7fffffff;
+
+    if (n > maxRows || numDirectories > maxRows
+        || !fits(h->pathOffsets, n + 1, sizeof(juce::uint32))
+        || !fits(h->strings, h->stringsSize, 1)
+        || !fits(h->fileSizes, n, sizeof(juce::int64))
+        || !fits(h->modificationTimes, n, sizeof(juce::int64))
+        || !fits(h->bpms, n, sizeof(float))
+        || !fits(h->durations, n, sizeof(float))
+        || !fits(h->ticksPerQuarter, n, sizeof(juce::uint16))
+        || !fits(h->barCounts, n, sizeof(juce::uint16))
+        || !fits(h->timeSignatures, n, sizeof(juce::uint16))
+        || !fits(h->timeSignatureFlags, n, sizeof(juce::uint8))
+        || !fits(h->fillBars, n, sizeof(juce::uint64))
+        || !fits(h->partsMasks, n, sizeof(juce::uint16))
+        || !fits(h->sourceLibraries, n, sizeof(juce::uint8))
+        || !fits(h->features, n, sizeof(RhythmFeatures))
+        || !fits(h->fingerprints, n, sizeof(GrooveFingerprint))
+        || !fits(h->contentHashes, n, sizeof(juce::uint64))
+        || !fits(h->onsetHashes, n, sizeof(juce::uint64))
+        || !fits(h->detectedLibraries, n, sizeof(juce::uint8))
+        || !fits(h->noteMasks, n, 2 * sizeof(juce::uint64))
+        || !fits(h->directoryPathOffsets, numDirectories + 1, sizeof(juce::uint32))
+        || !fits(h->directoryStrings, h->directoryStringsSize, 1)
+        || !fits(h->directoryModificationTimes, numDirectories, sizeof(juce::int64)))
+        return false;
+
+    base = static_cast<const char*>(data);
+    header = h;
+    return true;
+}
+
+GrooveLibraryIndex::Snapshot::PathTable GrooveLibraryIndex::Snapshot::getFileTable() const noexcept
+{
+    return { column<juce::uint32>(header->pathOffsets), base + header->strings,
+             header->stringsSize, static_cast<int>(header->numEntries) };
+}
+
+GrooveLibraryIndex::Snapshot::PathTable GrooveLibraryIndex::Snapshot::getDirectoryTable() const noexcept
+{
+    return { column<juce::uint32>(header->directoryPathOffsets), base + header->directoryStrings,
+             header->directoryStringsSize, static_cast<int>(header->numDirectories) };
+}
+
+int GrooveLibraryIndex::Snapshot::size() const noexcept
+{
+    return header != nullptr ? static_cast<int>(header->numEntries) : 0;
+}
+
+int GrooveLibraryIndex::Snapshot::indexOf(const juce::File& file) const
+{
+    return getFileTable().find(file.getFullPathName());
+}
+
+juce::String GrooveLibraryIndex::Snapshot::getPath(int row) const
+{
+    return getFileTable().getString(row);
+}
+
+const char* GrooveLibraryIndex::Snapshot::getPathUTF8(int row, size_t& length) const noexcept
+{
+    return getFileTable().get(row, length);
+}
+
+juce::int64 GrooveLibraryIndex::Snapshot::getFileSize(int row) const noexcept          { return column<juce::int64>(header->fileSizes)[row]; }
+juce::int64 GrooveLibraryIndex::Snapshot::getModificationTime(int row) const noexcept  { return column<juce::int64>(header->modificationTimes)[row]; }
+double GrooveLibraryIndex::Snapshot::getBpm(int row) const noexcept                    { return column<float>(header->bpms)[row]; }
+double GrooveLibraryIndex::Snapshot::getDurationSeconds(int row) const noexcept        { return column<float>(header->durations)[row]; }
+int GrooveLibraryIndex::Snapshot::getTicksPerQuarterNote(int row) const noexcept       { return column<juce::uint16>(header->ticksPerQuarter)[row]; }
+int GrooveLibraryIndex::Snapshot::getBarCount(int row) const noexcept                  { return column<juce::uint16>(header->barCounts)[row]; }
+int GrooveLibraryIndex::Snapshot::getTimeSignatureNumerator(int row) const noexcept   { return column<juce::uint16>(header->timeSignatures)[row] >> 8; }
+int GrooveLibraryIndex::Snapshot::getTimeSignatureDenominator(int row) const noexcept { return column<juce::uint16>(header->timeSignatures)[row] & 0xff; }
+bool GrooveLibraryIndex::Snapshot::isTimeSignatureDetected(int row) const noexcept     { return column<juce::uint8>(header->timeSignatureFlags)[row] != 0; }
+juce::uint64 GrooveLibraryIndex::Snapshot::getFillBars(int row) const noexcept        { return column<juce::uint64>(header->fillBars)[row]; }
+
+double GrooveLibraryIndex::Snapshot::getQuartersPerBar(int row) const noexcept
+{
+    const int denominator = getTimeSignatureDenominator(row);
+    return denominator > 0 ? getTimeSignatureNumerator(row) * 4.0 / denominator : 4.0;
+}
+juce::uint16 GrooveLibraryIndex::Snapshot::getPartsMask(int row) const noexcept        { return column<juce::uint16>(header->partsMasks)[row]; }
+DrumLibrary GrooveLibraryIndex::Snapshot::getSourceLibrary(int row) const noexcept     { return static_cast<DrumLibrary>(column<juce::uint8>(header->sourceLibraries)[row]); }
+const RhythmFeatures& GrooveLibraryIndex::Snapshot::getFeatures(int row) const noexcept { return column<RhythmFeatures>(header->features)[row]; }
+const GrooveFingerprint& GrooveLibraryIndex::Snapshot::getFingerprint(int row) const noexcept { return column<GrooveFingerprint>(header->fingerprints)[row]; }
+juce::uint64 GrooveLibraryIndex::Snapshot::getContentHash(int row) const noexcept      { return column<juce::uint64>(header->contentHashes)[row]; }
+juce::uint64 GrooveLibraryIndex::Snapshot::getOnsetHash(int row) const noexcept        { return column<juce::uint64>(header->onsetHashes)[row]; }
+DrumLibrary GrooveLibraryIndex::Snapshot::getDetectedLibrary(int row) const noexcept   { return static_cast<DrumLibrary>(column<juce::uint8>(header->detectedLibraries)[row]); }
+const std::array<juce::uint64, 2>& GrooveLibraryIndex::Snapshot::getNoteMask(int row) const noexcept { return column<std::array<juce::uint64, 2>>(header->noteMasks)[row]; }
+
+GrooveIndexEntry GrooveLibraryIndex::Snapshot::getEntry(int row) const
+{
+    GrooveIndexEntry entry;
+    entry.path = getPath(row);
+    entry.fileSize = getFileSize(row);
+    entry.modificationTime = getModificationTime(row);
+    entry.ticksPerQuarterNote = getTicksPerQuarterNote(row);
+    entry.bpm = getBpm(row);
+    entry.durationSeconds = getDurationSeconds(row);
+    entry.barCount = getBarCount(row);
+    entry.timeSignatureNumerator = static_cast<juce::uint8>(getTimeSignatureNumerator(row));
+    entry.timeSignatureDenominator = static_cast<juce::uint8>(getTimeSignatureDenominator(row));
+    entry.timeSignatureDetected = isTimeSignatureDetected(row);
+    entry.fillBars = getFillBars(row);
+    entry.partsMask = getPartsMask(row);
+    entry.sourceLibrary = getSourceLibrary(row);
+    entry.features = getFeatures(row);
+    entry.fingerprint = getFingerprint(row);
+    entry.contentHash = getContentHash(row);
+    entry.onsetHash = getOnsetHash(row);
+    entry.detectedLibrary = getDetectedLibrary(row);
+    entry.noteMask = getNoteMask(row);
+    return entry;
+}
+
+std::vector<juce::uint8> GrooveLibraryIndex::Snapshot::filter(const GrooveFilter& f) const
+{
+    const size_t n = static_cast<size_t>(size());
+    std::vector<juce::uint8> matches(n, 1);
+    juce::uint8* out = matches.data();
+
+    // Plain loops over contiguous columns without branches, so the compiler vectorises them
+
+    if (f.minBpm > 0.0 || f.maxBpm > 0.0)
+    {
+        const float low = static_cast<float>(f.minBpm);
+        const float high = f.maxBpm > 0.0 ? static_cast<float>(f.maxBpm) : std::numeric_limits<float>::max();
+        const float* bpms = column<float>(header->bpms);
+
+        for (size_t i = 0; i < n; ++i)
+            out[i] &= static_cast<juce::uint8>((bpms[i] >= low) & (bpms[i] <= high));
+    }
+
+    if (f.minBars > 0 || f.maxBars > 0)
+    {
+        const auto low = static_cast<juce::uint16>(juce::jlimit(0, 0xffff, f.minBars));
+        const auto high = static_cast<juce::uint16>(f.maxBars > 0 ? juce::jlimit(0, 0xffff, f.maxBars) : 0xffff);
+        const juce::uint16* bars = column<juce::uint16>(header->barCounts);
+
+        for (size_t i = 0; i < n; ++i)
+            out[i] &= static_cast<juce::uint8>((bars[i] >= low) & (bars[i] <= high));
+    }
+
+    if (f.timeSignatureNumerator > 0)
+    {
+        // Without a denominator only the numerator is compared
+        const juce::uint16 mask = f.timeSignatureDenominator > 0 ? 0xffff : 0xff00;
+        const auto wanted = static_cast<juce::uint16>((((f.timeSignatureNumerator & 0xff) << 8)
+                                                       | (f.timeSignatureDenominator & 0xff)) & mask);
+        const juce::uint16* signatures = column<juce::uint16>(header->timeSignatures);
+
+        for (size_t i = 0; i < n; ++i)
+            out[i] &= static_cast<juce::uint8>((signatures[i] & mask) == wanted);
+    }
+
+    if (f.fills != 0)
+    {
+        const juce::uint8 wanted = f.fills > 0 ? 1 : 0;
+        const juce::uint64* fills = column<juce::uint64>(header->fillBars);
+
+        for (size_t i = 0; i < n; ++i)
+            out[i] &= static_cast<juce::uint8>(static_cast<juce::uint8>(fills[i] != 0) == wanted);
+    }
+
+    if (f.doubleKick)
+    {
+        // Back-to-back kick 16ths in the fingerprint, a few times over its four bars
+        constexpr int minPairs = 4;
+        const auto* fingerprints = column<GrooveFingerprint>(header->fingerprints);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            const juce::uint64 kicks = fingerprints[i].lanes[GrooveFingerprint::kickLane];
+            out[i] &= static_cast<juce::uint8>(std::popcount(kicks & (kicks >> 1)) >= minPairs);
+        }
+    }
+
+    if (f.requiredParts != 0 || f.excludedParts != 0)
+    {
+        const juce::uint16 required = f.requiredParts;
+        const juce::uint16 excluded = f.excludedParts;
+        const juce::uint16* parts = column<juce::uint16>(header->partsMasks);
+
+        for (size_t i = 0; i < n; ++i)
+            out[i] &= static_cast<juce::uint8>(((parts[i] & required) == required) & ((parts[i] & excluded) == 0));
+    }
+
+    return matches;
+}
+
+std::vector<SimilarGroove> GrooveLibraryIndex::Snapshot::findSimilar(const GrooveFingerprint& fingerprint, int maxResults,
+                                                                    int excludedRow) const
+{
+    const size_t n = static_cast<size_t>(size());
+    if (n == 0 || maxResults <= 0 || fingerprint.isEmpty())
+        return {};
+
+    constexpr juce::uint16 noMatch = 0xffff;
+    constexpr int maxDistance = 64 * 4;
+
+    // One plain pass of xor + popcount over the 32-byte rows, about 4 ms for 200k rows
+    // without any target-specific flags; distances never exceed maxDistance
+    const auto* fingerprints = column<GrooveFingerprint>(header->fingerprints);
+    std::vector<juce::uint16> distances(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const auto& row = fingerprints[i];
+        const int distance = GrooveFingerprint::distance(fingerprint, row);
+        distances[i] = row.isEmpty() ? noMatch : static_cast<juce::uint16>(distance);
+    }
+
+    if (excludedRow >= 0 && static_cast<size_t>(excludedRow) < n)
+        distances[static_cast<size_t>(excludedRow)] = noMatch;
+
+    // Counting select: find the distance that admits maxResults rows, then collect only those
+    std::array<int, maxDistance + 1> histogram {};
+    for (const auto distance : distances)
+        if (distance != noMatch)
+            ++histogram[distance];
+
+    int cutoff = 0;
+    for (int total = 0; cutoff < maxDistance; ++cutoff)
+    {
+        total += histogram[static_cast<size_t>(cutoff)];
+        if (total >= maxResults)
+            break;
+    }
+
+    std::vector<SimilarGroove> results;
+    results.reserve(static_cast<size_t>(maxResults) + 16);
+
+    for (size_t i = 0; i < n; ++i)
+        if (distances[i] <= cutoff)
+            results.push_back({ static_cast<int>(i), distances[i] });
+
+    // Rows are in path order, so equal distances stay grouped by folder
+    std::stable_sort(results.begin(), results.end(), [](const SimilarGroove& a, const SimilarGroove& b)
+    {
+        return a.distance < b.distance;
+    });
+
+    if (results.size() > static_cast<size_t>(maxResults))
+        results.resize(static_cast<size_t>(maxResults));
+
+    return results;
+}
+
+juce::Array<int> GrooveLibraryIndex::Snapshot::findDuplicates(int row) const
+{
+    juce::Array<int> rows;
+
+    if (row < 0 || row >= size())
+        return rows;
+
+    const juce::uint64 wanted = getOnsetHash(row);
+    if (wanted == 0)
+        return rows;
+
+    const auto* hashes = column<juce::uint64>(header->onsetHashes);
+    const int n = size();
+
+    for (int i = 0; i < n; ++i)
+        if (hashes[i] == wanted)
+            rows.add(i);
+
+    return rows;
+}
+
+int GrooveLibraryIndex::Snapshot::addNoteUsage(const juce::File& folder, std::array<float, 128>& histogram) const
+{
+    const juce::String prefix = folder.getFullPathName() + juce::File::getSeparatorString();
+    const size_t prefixLength = prefix.getNumBytesAsUTF8();
+    const int n = size();
+    int numFiles = 0;
+
+    for (int row = 0; row < n; ++row)
+    {
+        size_t length = 0;
+        const char* path = getPathUTF8(row, length);
+
+        if (length <= prefixLength || std::memcmp(path, prefix.toRawUTF8(), prefixLength) != 0)
+            continue;
+
+        const auto& mask = getNoteMask(row);
+        for (size_t note = 0; note < histogram.size(); ++note)
+            histogram[note] += static_cast<float>((mask[note / 64] >> (note % 64)) & 1u);
+
+        ++numFiles;
+    }
+
+    return numFiles;
+}
+
+int GrooveLibraryIndex::Snapshot::getNumDirectories() const noexcept
+{
+    return header != nullptr ? static_cast<int>(header->numDirectories) : 0;
+}
+
+int GrooveLibraryIndex::Snapshot::indexOfDirectory(const juce::File& directory) const
+{
+    return getDirectoryTable().find(directory.getFullPathName());
+}
+
+juce::String GrooveLibraryIndex::Snapshot::getDirectoryPath(int directoryRow) const
+{
+    return getDirectoryTable().getString(directoryRow);
+}
+
+juce::int64 GrooveLibraryIndex::Snapshot::getDirectoryModificationTime(int directoryRow) const noexcept
+{
+    return column<juce::int64>(header->directoryModificationTimes)[directoryRow];
+}
+
+juce::Array<int> GrooveLibraryIndex::Snapshot::getRowsInDirectory(const juce::File& directory) const
+{
+    juce::Array<int> rows;
+    getFileTable().forEachDirectChild(directory, [&rows](int row) { rows.add(row); });
+    return rows;
+}
+
+juce::StringArray GrooveLibraryIndex::Snapshot::getChildDirectories(const juce::File& directory) const
+{
+    juce::StringArray children;
+    const auto table = getDirectoryTable();
+    table.forEachDirectChild(directory, [&](int row) { children.add(table.getString(row)); });
+    return children;
+}
+
+bool GrooveLibraryIndex::Snapshot::writeTo(const juce::File& file) const
+{
+    if (header == nullptr)
+        return false;
+
+    file.getParentDirectory().createDirectory();
+    juce::TemporaryFile temp(file);
+
+    if (!temp.getFile().replaceWithData(base, static_cast<size_t>(header->totalSize)))
+        return false;
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+class GrooveLibraryIndex::ScanThread : public juce::Thread
+{
+public:
+    ScanThread(GrooveLibraryIndex& o, const std::vector<RootFolder>& r, bool replace)
+        : juce::Thread("GrooveLibraryIndex scan"), owner(o), roots(r), replaceAll(replace)
+    {
+    }
+
+    ~ScanThread() override
+    {
+        stopThread(10000);
+    }
+
+    void run() override
+    {
+        const juce::ScopedLock ul(owner.updateLock);
+
+        runPipeline();
+
+        owner.enumerating = false;
+        owner.scanEndTime = juce::Time::getMillisecondCounterHiRes();
+    }
+
+private:
+    // Hands files from the folder walk to the workers. push() blocks while the
+    // queue is full, so the walk never runs far ahead of parsing.
+    class FileQueue
+    {
+    public:
+        bool push(RootFolder item, const juce::Thread& thread)
+        {
+            for (;;)
+            {
+                {
+                    const juce::ScopedLock sl(lock);
+                    if (items.size() < capacity)
+                    {
+                        items.push_back(std::move(item));
+                        itemAdded.signal();
+                        return true;
+                    }
+                }
+
+                if (thread.threadShouldExit())
+                    return false;
+
+                itemRemoved.wait(20);
+            }
+        }
+
+        // False once the queue is closed and drained, or the scan is cancelled
+        bool pop(RootFolder& item, const juce::Thread& thread)
+        {
+            for (;;)
+            {
+                {
+                    const juce::ScopedLock sl(lock);
+                    if (!items.empty())
+                    {
+                        item = std::move(items.front());
+                        items.pop_front();
+                        itemRemoved.signal();
+                        return true;
+                    }
+
+                    if (closed)
+                        return false;
+                }
+
+                if (thread.threadShouldExit())
+                    return false;
+
+                itemAdded.wait(20);
+            }
+        }
+
+        void close()
+        {
+            const juce::ScopedLock sl(lock);
+            closed = true;
+            itemAdded.signal();
+        }
+
+    private:
+        static constexpr size_t capacity = 256;
+
+        std::deque<RootFolder> items;
+        bool closed = false;
+        juce::CriticalSection lock;
+        juce::WaitableEvent itemAdded, itemRemoved;
+
+        JUCE_DECLARE_NON_COPYABLE(FileQueue)
+    };
+
+    void runPipeline()
+    {
+        previous = owner.getSnapshot();
+
+        // Workers start before the walk, so parsing begins with the first file found
+        const int numWorkers = juce::jmax(1, juce::SystemStats::getNumCpus() - 1);
+        juce::ThreadPool pool(numWorkers);
+
+        for (int i = 0; i < numWorkers; ++i)
+            pool.addJob([this] { parseQueuedFiles(); });
+
+        for (const auto& root : roots)
+        {
+            if (threadShouldExit())
+                break;
+
+            if (root.folder.isDirectory())
+                scanDirectory(root.folder, root.sourceLibrary);
+        }
+
+        queue.close();
+        owner.enumerating = false;
+
+        DBG("GrooveLibraryIndex: " + juce::String(static_cast<int>(reused.size())) + " files unchanged, parsing "
+            + juce::String(owner.totalFiles.load()));
+
+        while (pool.getNumJobs() > 0)
+        {
+            if (threadShouldExit())
+            {
+                pool.removeAllJobs(true, 10000);
+                DBG("GrooveLibraryIndex: Scan cancelled");
+                return;
+            }
+
+            wait(20);
+        }
+
+        std::vector<GrooveIndexEntry> entries = std::move(reused);
+
+        // A folder scan keeps everything outside the scanned roots
+        if (!replaceAll)
+        {
+            for (int row = 0; row < previous->size(); ++row)
+            {
+                if (!isScanned(previous->getPath(row)))
+                    entries.push_back(previous->getEntry(row));
+            }
+
+            for (int row = 0; row < previous->getNumDirectories(); ++row)
+            {
+                const juce::String path = previous->getDirectoryPath(row);
+                if (!isScanned(path))
+                    directories.push_back({ path, previous->getDirectoryModificationTime(row) });
+            }
+        }
+
+        entries.insert(entries.end(), std::make_move_iterator(parsed.begin()), std::make_move_iterator(parsed.end()));
+
+        owner.publish(Snapshot::createFromEntries(std::move(entries), std::move(directories)));
+    }
+
+    // Runs on every worker: reads, parses, dissects and extracts the features of one file at a time
+    void parseQueuedFiles()
+    {
+        RootFolder item;
+
+        while (queue.pop(item, *this))
+        {
+            GrooveIndexEntry entry;
+            const auto result = parseFile(item.folder, item.sourceLibrary, owner.libraryManager, entry);
+
+            if (result.wasOk())
+            {
+                owner.bytesRead += entry.fileSize;
+
+                const juce::ScopedLock sl(parsedLock);
+                parsed.push_back(std::move(entry));
+            }
+            else
+            {
+                ++owner.failedFiles;
+
+                const juce::ScopedLock sl(owner.scanErrorLock);
+                if (owner.scanErrors.size() < maxScanErrors)
+                    owner.scanErrors.push_back({ item.folder.getFullPathName(), result.getErrorMessage() });
+            }
+
+            ++owner.processedFiles;
+        }
+    }
+
+    void queueFile(const juce::File& file, DrumLibrary sourceLibrary)
+    {
+        ++owner.totalFiles;
+
+        if (!queue.push({ file, sourceLibrary }, *this))
+            --owner.totalFiles;
+    }
+
+    void reuseEntry(int row)
+    {
+        reused.push_back(previous->getEntry(row));
+        ++owner.reusedFiles;
+    }
+
+    bool isScanned(const juce::String& path) const
+    {
+        for (const auto& root : roots)
+        {
+            if (path == root.folder.getFullPathName() || isInsideRoot(path, root.folder))
+                return true;
+        }
+
+        return false;
+    }
+
+    void scanDirectory(const juce::File& directory, DrumLibrary sourceLibrary)
+    {
+        if (threadShouldExit())
+            return;
+
+        const juce::int64 modificationTime = directory.getLastModificationTime().toMilliseconds();
+        directories.push_back({ directory.getFullPathName(), modificationTime });
+
+        // Unchanged listing: skip listing it and descend into the known subdirectories. Saving over
+        // a file leaves the directory mtime alone, so each indexed file is still checked on its own.
+        const int directoryRow = previous->indexOfDirectory(directory);
+        if (directoryRow >= 0 && previous->getDirectoryModificationTime(directoryRow) == modificationTime)
+        {
+            for (int row : previous->getRowsInDirectory(directory))
+            {
+                const juce::File file(previous->getPath(row));
+                if (!file.existsAsFile())
+                    continue;
+
+                if (previous->getFileSize(row) == file.getSize()
+                    && previous->getModificationTime(row) == file.getLastModificationTime().toMilliseconds()
+                    && previous->getSourceLibrary(row) == sourceLibrary)
+                    reuseEntry(row);
+                else
+                    queueFile(file, sourceLibrary);
+            }
+
+            for (const auto& child : previous->getChildDirectories(directory))
+            {
+                const juce::File childDirectory(child);
+                if (childDirectory.isDirectory())
+                    scanDirectory(childDirectory, sourceLibrary);
+            }
+
+            return;
+        }
+
+        for (const auto& item : juce::RangedDirectoryIterator(directory, false, "*", juce::File::findFilesAndDirectories))
+        {
+            const juce::File file = item.getFile();
+
+            if (threadShouldExit())
+                return;
+
+            if (item.isDirectory())
+            {
+                scanDirectory(file, sourceLibrary);
+                continue;
+            }
+
+            if (!isMidiFile(file))
+                continue;
+
+            const int row = previous->indexOf(file);
+            if (row >= 0
+                && previous->getFileSize(row) == item.getFileSize()
+                && previous->getModificationTime(row) == item.getModificationTime().toMilliseconds()
+                && previous->getSourceLibrary(row) == sourceLibrary)
+            {
+                reuseEntry(row);
+            }
+            else
+            {
+                queueFile(file, sourceLibrary);
+            }
+        }
+    }
+
+    GrooveLibraryIndex& owner;
+    std::vector<RootFolder> roots;
+    bool replaceAll;
+
+    Snapshot::Ptr previous;
+    FileQueue queue;                            // folder = file to parse
+    std::vector<GrooveIndexEntry> reused;
+    std::vector<GrooveIndexEntry> parsed;
+    juce::CriticalSection parsedLock;
+    std::vector<GrooveIndexDirectory> directories;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ScanThread)
+};
+
+//==============================================================================
+#if JUCE_LINUX
+// Watches every directory below the roots with inotify and hands batches of
+// changes to the index once events have been quiet for a moment
+class GrooveLibraryIndex::FolderWatcher : public juce::Thread
+{
+public:
+    FolderWatcher(GrooveLibraryIndex& o, const std::vector<RootFolder>& r)
+        : juce::Thread("GrooveLibraryIndex watcher"), owner(o), roots(r)
+    {
+    }
+
+    ~FolderWatcher() override
+    {
+        stopThread(5000);
+    }
+
+    void run() override
+    {
+        inotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyHandle < 0)
+        {
+            DBG("GrooveLibraryIndex: inotify unavailable, live updates disabled");
+            return;
+        }
+
+        for (const auto& root : roots)
+            addWatches(root.folder);
+
+        alignas(inotify_event) char buffer[16384];
+
+        while (!threadShouldExit())
+        {
+            pollfd descriptor { inotifyHandle, POLLIN, 0 };
+
+            if (poll(&descriptor, 1, 100) > 0 && (descriptor.revents & POLLIN) != 0)
+            {
+                ssize_t length;
+                while ((length = read(inotifyHandle, buffer, sizeof(buffer))) > 0)
+                {
+                    for (char* pointer = buffer; pointer < buffer + length;)
+                    {
+                        const auto* event = reinterpret_cast<const inotify_event*>(pointer);
+                        handleEvent(*event);
+                        pointer += sizeof(inotify_event) + event->len;
+                    }
+                }
+            }
+
+            const juce::uint32 now = juce::Time::getMillisecondCounter();
+            const bool hasChanges = !changedFiles.empty() || !removedFiles.empty() || !removedDirectories.empty();
+
+            // Each batch rebuilds the snapshot, so a burst of saves is coalesced into few of them
+            if (hasChanges && now - lastApplyTime >= minApplyIntervalMs
+                && (now - lastEventTime >= quietPeriodMs || now - firstEventTime >= maxBatchDelayMs))
+            {
+                flush();
+                lastApplyTime = juce::Time::getMillisecondCounter();
+            }
+
+            if (hasUnsavedChanges && now - lastApplyTime >= saveDelayMs)
+                saveIndex();
+        }
+
+        if (hasUnsavedChanges)
+            saveIndex();
+
+        close(inotifyHandle);
+    }
+
+private:
+    static constexpr juce::uint32 quietPeriodMs = 250;
+    static constexpr juce::uint32 maxBatchDelayMs = 750;
+    static constexpr juce::uint32 minApplyIntervalMs = 2000;
+    static constexpr juce::uint32 saveDelayMs = 10000;
+
+    void saveIndex()
+    {
+        // A running scan saves when it publishes; until then this is tried again later
+        const juce::ScopedTryLock ul(owner.updateLock);
+        if (!ul.isLocked())
+            return;
+
+        owner.save();
+        hasUnsavedChanges = false;
+    }
+
+    void addWatches(const juce::File& directory)
+    {
+        const juce::String path = directory.getFullPathName();
+        const int watch = inotify_add_watch(inotifyHandle, path.toRawUTF8(),
+                                            IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR);
+        if (watch < 0)
+        {
+            DBG("GrooveLibraryIndex: Cannot watch " + path);
+            return;
+        }
+
+        watches[watch] = path;
+
+        for (const auto& child : directory.findChildFiles(juce::File::findDirectories, false))
+            addWatches(child);
+    }
+
+    void handleEvent(const inotify_event& event)
+    {
+        if ((event.mask & IN_Q_OVERFLOW) != 0)
+        {
+            rescanAfterOverflow();
+            return;
+        }
+
+        if ((event.mask & IN_IGNORED) != 0)
+        {
+            watches.erase(event.wd);
+            return;
+        }
+
+        auto watch = watches.find(event.wd);
+        if (watch == watches.end() || event.len == 0)
+            return;
+
+        const juce::File item = juce::File(watch->second).getChildFile(juce::String::fromUTF8(event.name));
+        const juce::String path = item.getFullPathName();
+
+        if ((event.mask & IN_ISDIR) != 0)
+        {
+            if ((event.mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+            {
+                addWatches(item);
+                removedDirectories.erase(path);
+
+                for (const auto& file : item.findChildFiles(juce::File::findFiles, true, "*.mid;*.midi;*.MID;*.MIDI"))
+                    changedFiles.insert(file.getFullPathName());
+            }
+            else if ((event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+            {
+                removedDirectories.insert(path);
+            }
+        }
+        else if (isMidiFile(item))
+        {
+            if ((event.mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) != 0)
+            {
+                changedFiles.insert(path);
+                removedFiles.erase(path);
+            }
+            else if ((event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+            {
+                removedFiles.insert(path);
+                changedFiles.erase(path);
+            }
+            else
+            {
+                return;
+            }
+        }
+        else
+        {
+            return;
+        }
+
+        const juce::uint32 now = juce::Time::getMillisecondCounter();
+        if (changedFiles.size() + removedFiles.size() + removedDirectories.size() == 1)
+            firstEventTime = now;
+        lastEventTime = now;
+    }
+
+    // Events were dropped, so nothing is known about what changed: watch any directories
+    // created meanwhile and compare every file below the roots with the index. Unchanged
+    // files are skipped by applyFileChanges without being parsed.
+    void rescanAfterOverflow()
+    {
+        DBG("GrooveLibraryIndex: inotify queue overflowed, rescanning watched folders");
+
+        const auto snapshot = owner.getSnapshot();
+
+        for (const auto& root : roots)
+        {
+            addWatches(root.folder);
+
+            for (const auto& file : root.folder.findChildFiles(juce::File::findFiles, true, "*.mid;*.midi;*.MID;*.MIDI"))
+            {
+                changedFiles.insert(file.getFullPathName());
+                removedFiles.erase(file.getFullPathName());
+            }
+        }
+
+        for (int row = 0; row < snapshot->size(); ++row)
+        {
+            const juce::String path = snapshot->getPath(row);
+            if (changedFiles.count(path) == 0 && isWatched(path))
+                removedFiles.insert(path);
+        }
+
+        for (int row = 0; row < snapshot->getNumDirectories(); ++row)
+        {
+            const juce::String path = snapshot->getDirectoryPath(row);
+            if (isWatched(path) && !juce::File(path).isDirectory())
+                removedDirectories.insert(path);
+        }
+
+        const juce::uint32 now = juce::Time::getMillisecondCounter();
+        firstEventTime = now;
+        lastEventTime = now;
+    }
+
+    bool isWatched(const juce::String& path) const
+    {
+        for (const auto& root : roots)
+        {
+            if (isInsideRoot(path, root.folder))
+                return true;
+        }
+
+        return false;
+    }
+
+    void flush()
+    {
+        FileChanges changes;
+
+        for (const auto& path : changedFiles)
+        {
+            // The longest matching root decides the source library
+            const RootFolder* bestRoot = nullptr;
+            for (const auto& root : roots)
+            {
+                if (isInsideRoot(path, root.folder)
+                    && (bestRoot == nullptr || root.folder.isAChildOf(bestRoot->folder)))
+                    bestRoot = &root;
+            }
+
+            if (bestRoot != nullptr)
+                changes.changedFiles.push_back({ juce::File(path), bestRoot->sourceLibrary });
+        }
+
+        for (const auto& path : removedFiles)
+            changes.removedFiles.add(path);
+
+        for (const auto& path : removedDirectories)
+            changes.removedDirectories.add(path);
+
+        changedFiles.clear();
+        removedFiles.clear();
+        removedDirectories.clear();
+
+        // Published straight away, written to disk once the changes settle
+        if (owner.applyFileChanges(changes))
+            hasUnsavedChanges = true;
+    }
+
+    GrooveLibraryIndex& owner;
+    std::vector<RootFolder> roots;
+
+    int inotifyHandle = -1;
+    std::unordered_map<int, juce::String> watches;
+
+    std::unordered_set<juce::String> changedFiles;
+    std::unordered_set<juce::String> removedFiles;
+    std::unordered_set<juce::String> removedDirectories;
+    juce::uint32 firstEventTime = 0;
+    juce::uint32 lastEventTime = 0;
+    juce::uint32 lastApplyTime = 0;
+    bool hasUnsavedChanges = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FolderWatcher)
+};
+#else
+class GrooveLibraryIndex::FolderWatcher {};
+#endif
+
+//==============================================================================
+GrooveLibraryIndex::GrooveLibraryIndex(const DrumLibraryManager& manager)
+    : libraryManager(manager), snapshot(Snapshot::createEmpty())
+{
+}
+
+GrooveLibraryIndex::~GrooveLibraryIndex()
+{
+    // Scan first, so the watcher can save what it has applied on its way out
+    cancelScan();
+    folderWatcher.reset();
+}
+
+void GrooveLibraryIndex::rescan(const std::vector<RootFolder>& roots)
+{
+    startScan(roots, true);
+}
+
+void GrooveLibraryIndex::indexFolder(const juce::File& folder, DrumLibrary sourceLibrary)
+{
+    startScan({ { folder, sourceLibrary } }, false);
+}
+
+void GrooveLibraryIndex::removeRoot(const juce::File& folder, const std::vector<RootFolder>& remainingRoots)
+{
+    // A scan in flight could still publish rows of the removed root
+    if (isScanning())
+    {
+        rescan(remainingRoots);
+        return;
+    }
+
+    const juce::ScopedLock ul(updateLock);
+
+    auto previous = getSnapshot();
+
+    auto isRemoved = [&](const juce::String& path)
+    {
+        if (path != folder.getFullPathName() && !isInsideRoot(path, folder))
+            return false;
+
+        for (const auto& root : remainingRoots)
+        {
+            if (path == root.folder.getFullPathName() || isInsideRoot(path, root.folder))
+                return false;
+        }
+
+        return true;
+    };
+
+    juce::StringArray removedPaths;
+    std::vector<GrooveIndexEntry> entries;
+    entries.reserve(static_cast<size_t>(previous->size()));
+
+    for (int row = 0; row < previous->size(); ++row)
+    {
+        const juce::String path = previous->getPath(row);
+
+        if (isRemoved(path))
+            removedPaths.add(path);
+        else
+            entries.push_back(previous->getEntry(row));
+    }
+
+    std::vector<GrooveIndexDirectory> directories;
+    for (int row = 0; row < previous->getNumDirectories(); ++row)
+    {
+        const juce::String path = previous->getDirectoryPath(row);
+        if (!isRemoved(path))
+            directories.push_back({ path, previous->getDirectoryModificationTime(row) });
+    }
+
+    if (removedPaths.isEmpty() && static_cast<int>(directories.size()) == previous->getNumDirectories())
+        return;
+
+    DBG("GrooveLibraryIndex: Removing " + juce::String(removedPaths.size()) + " files of " + folder.getFullPathName());
+
+    publish(Snapshot::createFromEntries(std::move(entries), std::move(directories)));
+
+    const juce::ScopedLock cl(callbackLock);
+    if (onFilesChanged)
+        onFilesChanged(removedPaths);
+}
+
+void GrooveLibraryIndex::startScan(const std::vector<RootFolder>& roots, bool replaceAll)
+{
+    cancelScan();
+
+    totalFiles = 0;
+    processedFiles = 0;
+    failedFiles = 0;
+    reusedFiles = 0;
+    bytesRead = 0;
+    enumerating = true;
+    scanStartTime = juce::Time::getMillisecondCounterHiRes();
+    scanEndTime = 0.0;
+
+    {
+        const juce::ScopedLock sl(scanErrorLock);
+        scanErrors.clear();
+    }
+
+    scanThread = std::make_unique<ScanThread>(*this, roots, replaceAll);
+    scanThread->startThread(juce::Thread::Priority::low);
+}
+
+void GrooveLibraryIndex::cancelScan()
+{
+    if (scanThread != nullptr)
+        scanThread.reset();   // Stops and joins
+}
+
+bool GrooveLibraryIndex::isScanning() const
+{
+    return scanThread != nullptr && scanThread->isThreadRunning();
+}
+
+double GrooveLibraryIndex::getProgress() const
+{
+    const int total = totalFiles.load();
+    return total > 0 ? static_cast<double>(processedFiles.load()) / static_cast<double>(total) : 0.0;
+}
+
+GrooveLibraryIndex::ScanProgress GrooveLibraryIndex::getScanProgress() const
+{
+    ScanProgress progress;
+    progress.enumerating = enumerating.load();
+    progress.filesFound = totalFiles.load();
+    progress.filesProcessed = processedFiles.load();
+    progress.filesFailed = failedFiles.load();
+    progress.filesReused = reusedFiles.load();
+    progress.bytesRead = bytesRead.load();
+
+    const double endTime = scanEndTime.load();
+    const double startTime = scanStartTime.load();
+    if (startTime > 0.0)
+        progress.elapsedSeconds = ((endTime > 0.0 ? endTime : juce::Time::getMillisecondCounterHiRes()) - startTime) / 1000.0;
+
+    return progress;
+}
+
+std::vector<GrooveLibraryIndex::ScanError> GrooveLibraryIndex::getScanErrors() const
+{
+    const juce::ScopedLock sl(scanErrorLock);
+    return scanErrors;
+}
+
+void GrooveLibraryIndex::watchFolders(const std::vector<RootFolder>& roots)
+{
+    folderWatcher.reset();
+
+   #if JUCE_LINUX
+    if (!roots.empty())
+    {
+        folderWatcher = std::make_unique<FolderWatcher>(*this, roots);
+        folderWatcher->startThread(juce::Thread::Priority::low);
+    }
+   #else
+    juce::ignoreUnused(roots);
+   #endif
+}
+
+void GrooveLibraryIndex::setFilesChangedCallback(std::function<void(const juce::StringArray&)> callback)
+{
+    const juce::ScopedLock cl(callbackLock);
+    onFilesChanged = std::move(callback);
+}
+
+bool GrooveLibraryIndex::applyFileChanges(const FileChanges& changes)
+{
+    const juce::ScopedLock ul(updateLock);
+
+    auto previous = getSnapshot();
+
+    std::unordered_set<juce::String> replacedPaths;
+    juce::StringArray affectedPaths;
+    std::vector<GrooveIndexEntry> entries;
+
+    for (const auto& changed : changes.changedFiles)
+    {
+        // Closed after writing but left as it was, e.g. by an editor saving without changes
+        const int row = previous->indexOf(changed.folder);
+        if (row >= 0
+            && previous->getFileSize(row) == changed.folder.getSize()
+            && previous->getModificationTime(row) == changed.folder.getLastModificationTime().toMilliseconds()
+            && previous->getSourceLibrary(row) == changed.sourceLibrary)
+            continue;
+
+        const juce::String path = changed.folder.getFullPathName();
+        replacedPaths.insert(path);
+        affectedPaths.add(path);
+
+        GrooveIndexEntry entry;
+        if (changed.folder.existsAsFile() && parseFile(changed.folder, changed.sourceLibrary, libraryManager, entry))
+            entries.push_back(std::move(entry));
+    }
+
+    for (const auto& path : changes.removedFiles)
+    {
+        replacedPaths.insert(path);
+        affectedPaths.add(path);
+    }
+
+    auto isRemovedDirectory = [&changes](const juce::String& path)
+    {
+        for (const auto& directory : changes.removedDirectories)
+        {
+            if (path == directory || isInsideRoot(path, juce::File(directory)))
+                return true;
+        }
+
+        return false;
+    };
+
+    if (replacedPaths.empty() && changes.removedDirectories.isEmpty())
+        return false;
+
+    for (int row = 0; row < previous->size(); ++row)
+    {
+        const juce::String path = previous->getPath(row);
+
+        if (replacedPaths.count(path) > 0)
+            continue;
+
+        if (isRemovedDirectory(path))
+        {
+            affectedPaths.add(path);
+            continue;
+        }
+
+        entries.push_back(previous->getEntry(row));
+    }
+
+    std::vector<GrooveIndexDirectory> directories;
+    for (int row = 0; row < previous->getNumDirectories(); ++row)
+    {
+        const juce::String path = previous->getDirectoryPath(row);
+        if (!isRemovedDirectory(path))
+            directories.push_back({ path, previous->getDirectoryModificationTime(row) });
+    }
+
+    DBG("GrooveLibraryIndex: Applying " + juce::String(affectedPaths.size()) + " file changes");
+
+    publish(Snapshot::createFromEntries(std::move(entries), std::move(directories)), false);
+
+    const juce::ScopedLock cl(callbackLock);
+    if (onFilesChanged)
+        onFilesChanged(affectedPaths);
+
+    return true;
+}
+
+GrooveLibraryIndex::Snapshot::Ptr GrooveLibraryIndex::getSnapshot() const
+{
+    const juce::ScopedLock sl(snapshotLock);
+    return snapshot;
+}
+
+void GrooveLibraryIndex::publish(Snapshot::Ptr newSnapshot, bool saveToDisk)
+{
+    {
+        const juce::ScopedLock sl(snapshotLock);
+        snapshot = newSnapshot;
+    }
+
+    DBG("GrooveLibraryIndex: " + juce::String(newSnapshot->size()) + " files indexed");
+
+    if (saveToDisk)
+        save();
+
+    sendChangeMessage();
+}
+
+//==============================================================================
+juce::File GrooveLibraryIndex::getIndexFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("DrumGroovePro")
+        .getChildFile("library.index");
+}
+
+juce::Array<juce::File> GrooveLibraryIndex::findIndexFiles()
+{
+    juce::Array<juce::File> files;
+
+    for (const auto& file : getIndexFile().getParentDirectory().findChildFiles(juce::File::findFiles, false, "library*.index"))
+    {
+        // Skips temporaries left by an interrupted save
+        if (getIndexGeneration(file) >= 0)
+            files.add(file);
+    }
+
+    std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b)
+    {
+        return getIndexGeneration(a) > getIndexGeneration(b);
+    });
+
+    return files;
+}
+
+juce::int64 GrooveLibraryIndex::getIndexGeneration(const juce::File& file)
+{
+    const auto name = file.getFileNameWithoutExtension();
+
+    // library.index from before generations were numbered
+    if (name == "library")
+        return 0;
+
+    const auto generation = name.fromFirstOccurrenceOf("library.", false, false);
+    if (!name.startsWith("library.") || generation.isEmpty() || !generation.containsOnly("0123456789"))
+        return -1;
+
+    return generation.getLargeIntValue();
+}
+
+bool GrooveLibraryIndex::load()
+{
+    // Mapped read-only: pages are only touched when rows are read
+    Snapshot::Ptr loaded;
+
+    for (const auto& file : findIndexFiles())
+    {
+        loaded = Snapshot::createFromFile(file);
+        if (loaded != nullptr)
+            break;
+    }
+
+    if (loaded == nullptr)
+        return false;
+
+    {
+        const juce::ScopedLock sl(snapshotLock);
+        snapshot = loaded;
+    }
+
+    DBG("GrooveLibraryIndex: Mapped " + juce::String(loaded->size()) + " entries");
+    return true;
+}
+
+bool GrooveLibraryIndex::save() const
+{
+    // Windows can't replace or delete a file while it is mapped, and the loaded snapshot maps
+    // the current index, so every save writes a new generation instead of overwriting it
+    const auto existing = findIndexFiles();
+    const juce::int64 generation = existing.isEmpty() ? 1 : getIndexGeneration(existing.getFirst()) + 1;
+    const auto file = getIndexFile().getSiblingFile("library." + juce::String(generation) + ".index");
+
+    if (!getSnapshot()->writeTo(file))
+    {
+        DBG("GrooveLibraryIndex: Failed to write " + file.getFullPathName());
+        return false;
+    }
+
+    // A generation that is still mapped is removed by a later save, once its snapshot is released
+    for (const auto& old : existing)
+    {
+        if (!old.deleteFile())
+            DBG("GrooveLibraryIndex: Keeping " + old.getFileName() + " while it is in use");
+    }
+
+    return true;
+}
+
+//==============================================================================
+double GrooveLibraryIndex::extractBpmFromFileName(const juce::String& fileNameWithoutExtension)
+{
+    constexpr int minPlausibleBpm = 40, maxPlausibleBpm = 300;
+
+    const juce::String name = fileNameWithoutExtension.toLowerCase();
+    const int length = name.length();
+    double delimitedNumber = 0.0;
+
+    for (int start = 0; start < length;)
+    {
+        if (!juce::CharacterFunctions::isDigit(name[start]))
+        {
+            ++start;
+            continue;
+        }
+
+        int end = start;
+        while (end < length && juce::CharacterFunctions::isDigit(name[end]))
+            ++end;
+
+        const int value = name.substring(start, end).getIntValue();
+        const bool plausible = end - start <= 3 && value >= minPlausibleBpm && value <= maxPlausibleBpm;
+
+        // "120bpm", "120 bpm", "120_bpm" - an explicit tag wins over anything else
+        int tag = end;
+        while (tag < length && (name[tag] == ' ' || name[tag] == '_' || name[tag] == '-'))
+            ++tag;
+
+        if (plausible && name.substring(tag, tag + 3) == "bpm")
+            return value;
+
+        // Otherwise the first number standing on its own, as in "_95_"
+        const bool delimitedBefore = start == 0 || !juce::CharacterFunctions::isLetterOrDigit(name[start - 1]);
+        const bool delimitedAfter = end == length || !juce::CharacterFunctions::isLetterOrDigit(name[end]);
+
+        if (plausible && delimitedBefore && delimitedAfter && delimitedNumber == 0.0)
+            delimitedNumber = value;
+
+        start = end;
+    }
+
+    return delimitedNumber;
+}
+
+juce::Result GrooveLibraryIndex::parseFile(const juce::File& file, DrumLibrary sourceLibrary,
+                                           const DrumLibraryManager& libraryManager, GrooveIndexEntry& entry)
+{
+    juce::MemoryBlock data;
+    if (!file.loadFileAsData(data))
+        return juce::Result::fail("Could not be read");
+
+    juce::MemoryInputStream in(data, false);
+    juce::MidiFile midiFile;
+    if (!midiFile.readFrom(in))
+        return juce::Result::fail("Not a valid MIDI file");
+
+    entry.path = file.getFullPathName();
+    entry.fileSize = static_cast<juce::int64>(data.getSize());
+    entry.modificationTime = file.getLastModificationTime().toMilliseconds();
+    entry.sourceLibrary = sourceLibrary;
+
+    const short timeFormat = midiFile.getTimeFormat();
+    entry.ticksPerQuarterNote = timeFormat > 0 ? timeFormat : 480;
+
+    // First tempo event wins, then a BPM in the file name, then 120 BPM
+    juce::MidiMessageSequence tempoEvents;
+    midiFile.findAllTempoEvents(tempoEvents);
+    if (tempoEvents.getNumEvents() > 0
+        && tempoEvents.getEventPointer(0)->message.getTempoSecondsPerQuarterNote() > 0.0)
+    {
+        entry.bpm = 60.0 / tempoEvents.getEventPointer(0)->message.getTempoSecondsPerQuarterNote();
+    }
+    else if (const double fileNameBpm = extractBpmFromFileName(file.getFileNameWithoutExtension()); fileNameBpm > 0.0)
+    {
+        entry.bpm = fileNameBpm;
+    }
+
+    // First time signature event wins; files without one are detected from their onsets below
+    juce::MidiMessageSequence timeSignatureEvents;
+    midiFile.findAllTimeSigEvents(timeSignatureEvents);
+    bool hasTimeSignature = false;
+    if (timeSignatureEvents.getNumEvents() > 0)
+    {
+        int numerator = 4, denominator = 4;
+        timeSignatureEvents.getEventPointer(0)->message.getTimeSignatureInfo(numerator, denominator);
+
+        if (numerator > 0 && numerator < 256 && denominator > 0 && denominator < 256)
+        {
+            entry.timeSignatureNumerator = static_cast<juce::uint8>(numerator);
+            entry.timeSignatureDenominator = static_cast<juce::uint8>(denominator);
+            hasTimeSignature = true;
+        }
+    }
+
+    // Which library the notes fit best; stands in for an Unknown root library below
+    SourceLibraryDetector::NoteHistogram histogram {};
+    SourceLibraryDetector::addNotes(midiFile, histogram);
+    entry.detectedLibrary = libraryManager.getSourceLibraryDetector().classify(histogram).library;
+
+    for (size_t note = 0; note < histogram.size(); ++note)
+        if (histogram[note] > 0.0f)
+            entry.noteMask[note / 64] |= static_cast<juce::uint64>(1) << (note % 64);
+
+    const DrumLibrary partsLibrary = sourceLibrary == DrumLibrary::Unknown ? entry.detectedLibrary : sourceLibrary;
+
+    MidiDissector dissector;
+    auto parts = dissector.dissectSourceParts(midiFile, partsLibrary, libraryManager);
+
+    RhythmFeatureBuilder builder(entry.ticksPerQuarterNote);
+
+    for (const auto& part : parts)
+    {
+        entry.partsMask |= static_cast<juce::uint16>(1u << static_cast<int>(part.type));
+
+        for (const auto* event : part.getSequence())
+        {
+            if (event->message.isNoteOn())
+                builder.addOnset(event->message.getTimeStamp(), event->message.getVelocity());
+        }
+    }
+
+    entry.features = builder.build();
+
+    if (!hasTimeSignature)
+    {
+        int numerator = 4, denominator = 4;
+        if (MidiDissector::detectTimeSignature(parts, entry.ticksPerQuarterNote, numerator, denominator))
+        {
+            entry.timeSignatureNumerator = static_cast<juce::uint8>(numerator);
+            entry.timeSignatureDenominator = static_cast<juce::uint8>(denominator);
+            entry.timeSignatureDetected = true;
+        }
+    }
+
+    const double lastTick = midiFile.getLastTimestamp();
+    const double quarters = lastTick / entry.ticksPerQuarterNote;
+    const double quartersPerBar = entry.timeSignatureNumerator * 4.0 / entry.timeSignatureDenominator;
+    entry.durationSeconds = quarters * 60.0 / entry.bpm;
+    entry.barCount = lastTick > 0.0 ? static_cast<int>(std::ceil(quarters / quartersPerBar - 1.0e-6)) : 0;
+    entry.fillBars = MidiDissector::findFillBars(parts, quartersPerBar * entry.ticksPerQuarterNote);
+
+    entry.fingerprint = MidiDissector::computeFingerprint(parts);
+    hashCanonicalEvents(parts, entry.ticksPerQuarterNote,
+                        libraryManager.getNoteMap(partsLibrary, DrumLibrary::GeneralMIDI),
+                        entry.contentHash, entry.onsetHash);
+    return juce::Result::ok();
+}
@@ -0,0 +1,312 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "DrumLibraryManager.h"
+#include "RhythmFeatures.h"
+
+/**
+ * One MIDI file in the groove library, as stored in the index.
+ */
+struct GrooveIndexEntry
+{
+    juce::String path;
+    juce::int64 fileSize = 0;
+    juce::int64 modificationTime = 0;
+    int ticksPerQuarterNote = 480;
+    double bpm = 120.0;
+    double durationSeconds = 0.0;
+    int barCount = 0;
+    juce::uint8 timeSignatureNumerator = 4;
+    juce::uint8 timeSignatureDenominator = 4;
+    bool timeSignatureDetected = false; // From the onsets; the file had no time signature event
+    juce::uint64 fillBars = 0;          // Bit n set = bar n looks like a fill
+    juce::uint16 partsMask = 0;        // Bit n set = DrumPartType n present
+    DrumLibrary sourceLibrary = DrumLibrary::Unknown;
+    RhythmFeatures features;           // All parts combined
+    GrooveFingerprint fingerprint;     // Kick, snare and hi-hat lanes for similarity search
+    juce::uint64 contentHash = 0;      // Note-ons in General MIDI form, with velocities; 0 = no notes
+    juce::uint64 onsetHash = 0;        // The same without velocities, shared by near-duplicates
+    DrumLibrary detectedLibrary = DrumLibrary::Unknown;   // Best match of the notes played
+    std::array<juce::uint64, 2> noteMask {};              // Bit n set = note n is played
+};
+
+/**
+ * A scanned directory and its modification time, used to skip unchanged
+ * directories on the next rescan.
+ */
+struct GrooveIndexDirectory
+{
+    juce::String path;
+    juce::int64 modificationTime = 0;
+};
+
+/**
+ * Facets the browser can filter the index by. Zero means "any" for every bound.
+ */
+struct GrooveFilter
+{
+    double minBpm = 0.0;
+    double maxBpm = 0.0;
+    int minBars = 0;
+    int maxBars = 0;
+    int timeSignatureNumerator = 0;
+    int timeSignatureDenominator = 0;
+    juce::uint16 requiredParts = 0;    // DrumPartType bits that must be present
+    juce::uint16 excludedParts = 0;    // DrumPartType bits that must be absent
+    int fills = 0;                     // 1 = has a fill bar, -1 = has none
+    bool doubleKick = false;           // Kicks on back-to-back 16ths
+
+    bool isActive() const noexcept
+    {
+        return minBpm > 0.0 || maxBpm > 0.0 || minBars > 0 || maxBars > 0
+            || timeSignatureNumerator > 0 || requiredParts != 0 || excludedParts != 0 || fills != 0
+            || doubleKick;
+    }
+};
+
+/**
+ * A groove near another one, by fingerprint Hamming distance.
+ */
+struct SimilarGroove
+{
+    int row = -1;
+    int distance = 0;     // 16ths that differ over all lanes
+};
+
+/**
+ * Persistent index of every MIDI file below the registered root folders.
+ *
+ * Scans run as a pipeline: one thread walks the folders and feeds a bounded
+ * queue that a pool of workers drains, each reading, parsing, dissecting and
+ * extracting features from one file at a time, while results are collected
+ * for the snapshot that is published at the end. Parsing starts with the
+ * first file found, and a cancelled scan stops at the next file in every
+ * stage. Files are parsed once; the browser and search read the
+ * published snapshot instead of touching the filesystem. The index lives
+ * next to config.xml as a versioned fixed-layout binary file (header, path
+ * offset table, string table, one array per column) that is memory-mapped
+ * read-only at startup, so nothing is parsed up front. Saves write a new
+ * library.<generation>.index rather than replacing the mapped one, and
+ * older generations are deleted once they are no longer mapped.
+ *
+ * Rescans are incremental: directories whose mtime is unchanged reuse their
+ * indexed rows without listing, and files whose size and mtime are unchanged
+ * are not parsed again; files in unchanged directories are still checked
+ * one by one, since saving over a file leaves its directory's mtime alone.
+ * On Linux the root folders are also watched with inotify. Changes are
+ * applied in batches at most every couple of seconds, and the index file is
+ * written once they have settled.
+ */
+class GrooveLibraryIndex : public juce::ChangeBroadcaster
+{
+public:
+    struct RootFolder
+    {
+        juce::File folder;
+        DrumLibrary sourceLibrary = DrumLibrary::Unknown;
+    };
+
+    // Counters of the scan in progress, or of the last one
+    struct ScanProgress
+    {
+        bool enumerating = false;      // Still walking folders; filesFound keeps growing
+        int filesFound = 0;            // Files queued for parsing
+        int filesProcessed = 0;        // Parsed or failed
+        int filesFailed = 0;
+        int filesReused = 0;           // Unchanged files taken over from the index, not parsed
+        juce::int64 bytesRead = 0;
+        double elapsedSeconds = 0.0;
+
+        double getFilesPerSecond() const noexcept { return elapsedSeconds > 0.0 ? filesProcessed / elapsedSeconds : 0.0; }
+    };
+
+    struct ScanError
+    {
+        juce::String path;
+        juce::String reason;
+    };
+
+    // Immutable columnar view of the index, either memory-mapped from disk or built
+    // in memory by a scan. Rows are sorted by path. Hold on to the Ptr while reading.
+    class Snapshot : public juce::ReferenceCountedObject
+    {
+    public:
+        using Ptr = juce::ReferenceCountedObjectPtr<Snapshot>;
+
+        static Ptr createEmpty();
+        static Ptr createFromEntries(std::vector<GrooveIndexEntry> entries,
+                                     std::vector<GrooveIndexDirectory> directories);
+        static Ptr createFromFile(const juce::File& indexFile);
+
+        int size() const noexcept;
+        int indexOf(const juce::File& file) const;    // -1 if the file is not indexed
+
+        juce::String getPath(int row) const;
+        const char* getPathUTF8(int row, size_t& length) const noexcept;   // Not terminated, lives as long as the snapshot
+        juce::int64 getFileSize(int row) const noexcept;
+        juce::int64 getModificationTime(int row) const noexcept;
+        double getBpm(int row) const noexcept;
+        double getDurationSeconds(int row) const noexcept;
+        int getTicksPerQuarterNote(int row) const noexcept;
+        int getBarCount(int row) const noexcept;
+        int getTimeSignatureNumerator(int row) const noexcept;
+        int getTimeSignatureDenominator(int row) const noexcept;
+        bool isTimeSignatureDetected(int row) const noexcept;
+        juce::uint64 getFillBars(int row) const noexcept;
+        double getQuartersPerBar(int row) const noexcept;
+        juce::uint16 getPartsMask(int row) const noexcept;
+        DrumLibrary getSourceLibrary(int row) const noexcept;
+        const RhythmFeatures& getFeatures(int row) const noexcept;
+        const GrooveFingerprint& getFingerprint(int row) const noexcept;
+        juce::uint64 getContentHash(int row) const noexcept;
+        juce::uint64 getOnsetHash(int row) const noexcept;
+        DrumLibrary getDetectedLibrary(int row) const noexcept;
+        const std::array<juce::uint64, 2>& getNoteMask(int row) const noexcept;
+
+        // Adds, per note, the number of indexed files below the folder that play it.
+        // Returns the number of files.
+        int addNoteUsage(const juce::File& folder, std::array<float, 128>& histogram) const;
+
+        GrooveIndexEntry getEntry(int row) const;
+
+        // One byte per row, non-zero where the row passes the filter. Runs one
+        // branch-free pass per active facet over its column.
+        std::vector<juce::uint8> filter(const GrooveFilter& filter) const;
+
+        // Rows closest to the fingerprint, closest first. A brute-force popcount
+        // scan over the fingerprint column; empty grooves are never returned.
+        std::vector<SimilarGroove> findSimilar(const GrooveFingerprint& fingerprint, int maxResults,
+                                               int excludedRow = -1) const;
+
+        // Copies of a groove anywhere in the library, whatever library's note map
+        // they use: rows with the same onsets (exact duplicates have the same
+        // content hash too). Includes the row itself; empty if it has no notes.
+        juce::Array<int> findDuplicates(int row) const;
+
+        // Directory table
+        int getNumDirectories() const noexcept;
+        int indexOfDirectory(const juce::File& directory) const;
+        juce::String getDirectoryPath(int directoryRow) const;
+        juce::int64 getDirectoryModificationTime(int directoryRow) const noexcept;
+
+        // Rows of the files directly inside a directory (not in its subdirectories)
+        juce::Array<int> getRowsInDirectory(const juce::File& directory) const;
+        juce::StringArray getChildDirectories(const juce::File& directory) const;
+
+        bool writeTo(const juce::File& file) const;
+
+        struct Header;
+        struct PathTable;
+
+    private:
+        Snapshot() = default;
+        bool attach(const void* data, size_t dataSize);
+        PathTable getFileTable() const noexcept;
+        PathTable getDirectoryTable() const noexcept;
+
+        template <typename T>
+        const T* column(juce::uint64 offset) const noexcept { return reinterpret_cast<const T*>(base + offset); }
+
+        std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+        juce::MemoryBlock ownedData;
+        const char* base = nullptr;
+        const Header* header = nullptr;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Snapshot)
+    };
+
+    explicit GrooveLibraryIndex(const DrumLibraryManager& libraryManager);
+    ~GrooveLibraryIndex() override;
+
+    // Re-indexes all given roots, replacing the current contents. Unchanged
+    // directories and files are taken over from the current snapshot.
+    void rescan(const std::vector<RootFolder>& roots);
+
+    // Indexes one folder and merges it into the current contents
+    void indexFolder(const juce::File& folder, DrumLibrary sourceLibrary);
+
+    // Drops the rows below a root that is no longer in the library, except
+    // those that are also below one of the remaining roots
+    void removeRoot(const juce::File& folder, const std::vector<RootFolder>& remainingRoots);
+
+    void cancelScan();
+    bool isScanning() const;
+    double getProgress() const;
+    int getNumFilesToScan() const { return totalFiles.load(); }
+    ScanProgress getScanProgress() const;
+    std::vector<ScanError> getScanErrors() const;
+
+    // Keeps the index up to date with changes below these folders (Linux only)
+    void watchFolders(const std::vector<RootFolder>& roots);
+
+    // The callback runs on a background thread with the paths of files that were
+    // modified, added or removed, so parse caches can drop them
+    void setFilesChangedCallback(std::function<void(const juce::StringArray&)> callback);
+
+    Snapshot::Ptr getSnapshot() const;
+
+    bool load();
+    bool save() const;
+
+    // Base name of the index files; other caches are stored next to it
+    static juce::File getIndexFile();
+
+    // BPM written in a file name ("Verse 120bpm", "groove_95_a"), 0 if there is none
+    static double extractBpmFromFileName(const juce::String& fileNameWithoutExtension);
+
+    // Parses one file into an index entry; safe to call from any thread
+    static juce::Result parseFile(const juce::File& file, DrumLibrary sourceLibrary,
+                          const DrumLibraryManager& libraryManager, GrooveIndexEntry& entry);
+
+private:
+    class ScanThread;
+    class FolderWatcher;
+
+    struct FileChanges
+    {
+        std::vector<RootFolder> changedFiles;     // folder = the file, with its root's library
+        juce::StringArray removedFiles;
+        juce::StringArray removedDirectories;
+    };
+
+    void startScan(const std::vector<RootFolder>& roots, bool replaceAll);
+    // False if nothing in the index changed
+    bool applyFileChanges(const FileChanges& changes);
+    void publish(Snapshot::Ptr newSnapshot, bool saveToDisk = true);
+
+    // Saved generations, newest first
+    static juce::Array<juce::File> findIndexFiles();
+    static juce::int64 getIndexGeneration(const juce::File& file);
+
+    const DrumLibraryManager& libraryManager;
+
+    Snapshot::Ptr snapshot;
+    juce::CriticalSection snapshotLock;
+
+    // Serialises read-modify-publish cycles of the scanner and the watcher
+    juce::CriticalSection updateLock;
+
+    std::function<void(const juce::StringArray&)> onFilesChanged;
+    juce::CriticalSection callbackLock;
+
+    std::unique_ptr<ScanThread> scanThread;
+    std::unique_ptr<FolderWatcher> folderWatcher;
+    std::atomic<int> totalFiles { 0 };
+    std::atomic<int> processedFiles { 0 };
+    std::atomic<int> failedFiles { 0 };
+    std::atomic<int> reusedFiles { 0 };
+    std::atomic<juce::int64> bytesRead { 0 };
+    std::atomic<bool> enumerating { false };
+    std::atomic<double> scanStartTime { 0.0 };
+    std::atomic<double> scanEndTime { 0.0 };
+
+    std::vector<ScanError> scanErrors;
+    juce::CriticalSection scanErrorLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GrooveLibraryIndex)
+};
@@ -0,0 +1,416 @@
+#include "GrooveSearchIndex.h"
+#include "MidiDissector.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_map>
+
+namespace
+{
+    // Lower-cases the text and splits it into space-separated words, also at
+    // camelCase and letter/digit boundaries ("GrooveFill120" -> "groove fill 120")
+    std::string normalise(const juce::String& text)
+    {
+        std::string result;
+        result.reserve(static_cast<size_t>(text.getNumBytesAsUTF8()) + 8);
+
+        juce::juce_wchar previous = 0;
+
+        for (auto p = text.getCharPointer(); !p.isEmpty();)
+        {
+            const juce::juce_wchar c = p.getAndAdvance();
+
+            if (!juce::CharacterFunctions::isLetterOrDigit(c))
+            {
+                if (!result.empty() && result.back() != ' ')
+                    result.push_back(' ');
+                previous = 0;
+                continue;
+            }
+
+            const bool isBoundary = previous != 0
+                && ((juce::CharacterFunctions::isLowerCase(previous) && juce::CharacterFunctions::isUpperCase(c))
+                    || (juce::CharacterFunctions::isDigit(previous) != juce::CharacterFunctions::isDigit(c)));
+
+            if (isBoundary && result.back() != ' ')
+                result.push_back(' ');
+
+            const juce::juce_wchar lower = juce::CharacterFunctions::toLowerCase(c);
+            if (lower < 0x80)
+                result.push_back(static_cast<char>(lower));
+            else
+                result += juce::String::charToString(lower).toStdString();
+
+            previous = c;
+        }
+
+        if (!result.empty() && result.back() == ' ')
+            result.pop_back();
+
+        return result;
+    }
+
+    std::vector<std::string> splitWords(const std::string& text)
+    {
+        std::vector<std::string> words;
+        size_t start = 0;
+
+        while (start < text.size())
+        {
+            size_t end = text.find(' ', start);
+            if (end == std::string::npos)
+                end = text.size();
+
+            if (end > start)
+                words.emplace_back(text, start, end - start);
+
+            start = end + 1;
+        }
+
+        return words;
+    }
+
+    juce::uint32 makeTrigram(unsigned char a, unsigned char b, unsigned char c)
+    {
+        return (static_cast<juce::uint32>(a) << 16) | (static_cast<juce::uint32>(b) << 8) | c;
+    }
+
+    // Trigrams of one word, including a leading " xy" so two-letter words and
+    // word starts are indexed too
+    void addWordTrigrams(const std::string& word, std::vector<juce::uint32>& trigrams)
+    {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(word.data());
+
+        if (word.size() >= 2)
+            trigrams.push_back(makeTrigram(' ', bytes[0], bytes[1]));
+
+        for (size_t i = 0; i + 2 < word.size(); ++i)
+            trigrams.push_back(makeTrigram(bytes[i], bytes[i + 1], bytes[i + 2]));
+    }
+
+    void sortUnique(std::vector<juce::uint32>& trigrams)
+    {
+        std::sort(trigrams.begin(), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    }
+
+    bool isWordStart(const std::string& text, size_t position)
+    {
+        return position == 0 || text[position - 1] == ' ';
+    }
+}
+
+//==============================================================================
+struct GrooveSearchIndex::Table
+{
+    struct Document
+    {
+        juce::String path;
+        juce::int64 modificationTime = 0;
+        bool isFolder = false;
+        std::string name;                       // Normalised file or folder name
+        std::string context;                    // Normalised parent folder names and tags
+        std::vector<juce::uint32> trigrams;     // Unique and sorted
+    };
+
+    std::vector<Document> documents;
+    std::unordered_map<juce::uint32, std::vector<int>> postings;   // Trigram -> ascending document ids
+};
+
+//==============================================================================
+class GrooveSearchIndex::BuildThread : public juce::Thread
+{
+public:
+    explicit BuildThread(GrooveSearchIndex& o)
+        : juce::Thread("GrooveSearchIndex build"), owner(o)
+    {
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            auto snapshot = owner.libraryIndex.getSnapshot();
+
+            std::shared_ptr<const Table> previous;
+            {
+                const juce::ScopedLock sl(owner.tableLock);
+                previous = owner.table;
+            }
+
+            if (auto built = build(*snapshot, previous.get()))
+                owner.publish(std::move(built));
+
+            // Woken by notify() when the library index publishes again
+            wait(-1);
+        }
+    }
+
+private:
+    std::shared_ptr<const Table> build(const GrooveLibraryIndex::Snapshot& snapshot, const Table* previous)
+    {
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+        std::unordered_map<juce::String, int> previousRows;
+        if (previous != nullptr)
+        {
+            previousRows.reserve(previous->documents.size());
+            for (size_t i = 0; i < previous->documents.size(); ++i)
+                previousRows.emplace(previous->documents[i].path, static_cast<int>(i));
+        }
+
+        auto newTable = std::make_shared<Table>();
+        auto& documents = newTable->documents;
+        documents.reserve(static_cast<size_t>(snapshot.getNumDirectories() + snapshot.size()));
+
+        int reused = 0;
+
+        auto addDocument = [&](const juce::String& path, juce::int64 modificationTime, bool isFolder,
+                               const std::function<juce::String()>& getTags)
+        {
+            const auto found = previousRows.find(path);
+            if (found != previousRows.end())
+            {
+                const auto& old = previous->documents[static_cast<size_t>(found->second)];
+
+                // A folder's name never changes with its mtime; a file's tags might
+                if (old.isFolder == isFolder && (isFolder || old.modificationTime == modificationTime))
+                {
+                    documents.push_back(old);
+                    documents.back().modificationTime = modificationTime;
+                    ++reused;
+                    return;
+                }
+            }
+
+            const juce::File file(path);
+            const auto parent = file.getParentDirectory();
+
+            Table::Document document;
+            document.path = path;
+            document.modificationTime = modificationTime;
+            document.isFolder = isFolder;
+            document.name = normalise(isFolder ? file.getFileName() : file.getFileNameWithoutExtension());
+            document.context = normalise(parent.getParentDirectory().getFileName() + " "
+                                         + parent.getFileName() + " " + getTags());
+
+            for (const auto& word : splitWords(document.name))
+                addWordTrigrams(word, document.trigrams);
+            for (const auto& word : splitWords(document.context))
+                addWordTrigrams(word, document.trigrams);
+            sortUnique(document.trigrams);
+
+            documents.push_back(std::move(document));
+        };
+
+        for (int row = 0; row < snapshot.getNumDirectories(); ++row)
+        {
+            addDocument(snapshot.getDirectoryPath(row), snapshot.getDirectoryModificationTime(row), true,
+                        [] { return juce::String(); });
+        }
+
+        for (int row = 0; row < snapshot.size(); ++row)
+        {
+            if ((row & 1023) == 0 && threadShouldExit())
+                return nullptr;
+
+            addDocument(snapshot.getPath(row), snapshot.getModificationTime(row), false, [&snapshot, row]
+            {
+                juce::String tags = juce::String(juce::roundToInt(snapshot.getBpm(row))) + "bpm";
+
+                const auto partsMask = snapshot.getPartsMask(row);
+                for (int type = 0; type < static_cast<int>(DrumPartType::COUNT); ++type)
+                    if ((partsMask & (1u << type)) != 0)
+                        tags << " " << MidiDissector::getPartDisplayName(static_cast<DrumPartType>(type));
+
+                const auto sourceLibrary = snapshot.getSourceLibrary(row);
+                if (sourceLibrary != DrumLibrary::Unknown)
+                    tags << " " << DrumLibraryManager::getLibraryName(sourceLibrary);
+
+                return tags;
+            });
+        }
+
+        for (size_t id = 0; id < documents.size(); ++id)
+        {
+            if ((id & 1023) == 0 && threadShouldExit())
+                return nullptr;
+
+            for (auto trigram : documents[id].trigrams)
+                newTable->postings[trigram].push_back(static_cast<int>(id));
+        }
+
+        DBG("GrooveSearchIndex: indexed " + juce::String(static_cast<int>(documents.size())) + " entries ("
+            + juce::String(reused) + " reused) in "
+            + juce::String(juce::Time::getMillisecondCounterHiRes() - startTime, 1) + " ms");
+
+        return newTable;
+    }
+
+    GrooveSearchIndex& owner;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BuildThread)
+};
+
+//==============================================================================
+GrooveSearchIndex::GrooveSearchIndex(GrooveLibraryIndex& index)
+    : libraryIndex(index)
+{
+    buildThread = std::make_unique<BuildThread>(*this);
+    buildThread->startThread(juce::Thread::Priority::low);
+
+    libraryIndex.addChangeListener(this);
+}
+
+GrooveSearchIndex::~GrooveSearchIndex()
+{
+    libraryIndex.removeChangeListener(this);
+    buildThread->stopThread(4000);
+}
+
+void GrooveSearchIndex::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    buildThread->notify();
+}
+
+void GrooveSearchIndex::publish(std::shared_ptr<const Table> newTable)
+{
+    {
+        const juce::ScopedLock sl(tableLock);
+        table = std::move(newTable);
+    }
+
+    sendChangeMessage();
+}
+
+int GrooveSearchIndex::getNumEntries() const
+{
+    const juce::ScopedLock sl(tableLock);
+    return table != nullptr ? static_cast<int>(table->documents.size()) : 0;
+}
+
+std::vector<GrooveSearchResult> GrooveSearchIndex::search(const juce::String& query, int maxResults) const
+{
+    std::shared_ptr<const Table> current;
+    {
+        const juce::ScopedLock sl(tableLock);
+        current = table;
+    }
+
+    if (current == nullptr || maxResults <= 0)
+        return {};
+
+    const auto words = splitWords(normalise(query));
+    if (words.empty())
+        return {};
+
+    const auto& documents = current->documents;
+
+    std::vector<juce::uint32> queryTrigrams;
+    for (const auto& word : words)
+        addWordTrigrams(word, queryTrigrams);
+    sortUnique(queryTrigrams);
+
+    // Candidates share enough trigrams with the query, which tolerates typos.
+    // Queries made only of single letters have no trigrams and scan everything.
+    std::vector<int> candidates;
+    std::vector<juce::uint16> matches;
+
+    if (!queryTrigrams.empty())
+    {
+        matches.assign(documents.size(), 0);
+
+        for (auto trigram : queryTrigrams)
+        {
+            const auto found = current->postings.find(trigram);
+            if (found == current->postings.end())
+                continue;
+
+            for (int id : found->second)
+                if (matches[static_cast<size_t>(id)]++ == 0)
+                    candidates.push_back(id);
+        }
+
+        const auto numTrigrams = static_cast<int>(queryTrigrams.size());
+        int required = juce::jmax(1, (numTrigrams + 1) / 2);
+
+        // Heavily misspelt queries fall back to a looser threshold
+        const bool anyStrongMatch = std::any_of(candidates.begin(), candidates.end(),
+                                                [&](int id) { return matches[static_cast<size_t>(id)] >= required; });
+        if (!anyStrongMatch)
+            required = juce::jmax(1, numTrigrams / 3);
+
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                        [&](int id) { return matches[static_cast<size_t>(id)] < required; }),
+                         candidates.end());
+    }
+    else
+    {
+        candidates.resize(documents.size());
+        for (size_t id = 0; id < documents.size(); ++id)
+            candidates[id] = static_cast<int>(id);
+    }
+
+    std::vector<std::pair<float, int>> scored;
+    scored.reserve(candidates.size());
+
+    for (int id : candidates)
+    {
+        const auto& document = documents[static_cast<size_t>(id)];
+
+        float score = queryTrigrams.empty()
+            ? 0.0f
+            : 2.0f * static_cast<float>(matches[static_cast<size_t>(id)]) / static_cast<float>(queryTrigrams.size());
+        bool rejected = false;
+
+        for (const auto& word : words)
+        {
+            const auto inName = document.name.find(word);
+            if (inName != std::string::npos)
+            {
+                score += isWordStart(document.name, inName) ? 4.0f : 3.0f;
+                continue;
+            }
+
+            const auto inContext = document.context.find(word);
+            if (inContext != std::string::npos)
+            {
+                score += isWordStart(document.context, inContext) ? 1.5f : 1.0f;
+                continue;
+            }
+
+            // Too short to be a misspelling of anything - it has to be there
+            if (word.size() < 3)
+            {
+                rejected = true;
+                break;
+            }
+        }
+
+        if (rejected)
+            continue;
+
+        if (document.name == words.front())
+            score += 2.0f;
+
+        // Shorter names rank first among otherwise equal matches
+        score -= 0.002f * static_cast<float>(document.name.size());
+
+        scored.emplace_back(score, id);
+    }
+
+    const auto numResults = juce::jmin(static_cast<size_t>(maxResults), scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + static_cast<std::ptrdiff_t>(numResults), scored.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::vector<GrooveSearchResult> results;
+    results.reserve(numResults);
+
+    for (size_t i = 0; i < numResults; ++i)
+    {
+        const auto& document = documents[static_cast<size_t>(scored[i].second)];
+        results.push_back({ juce::File(document.path), document.isFolder, scored[i].first });
+    }
+
+    return results;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "GrooveLibraryIndex.h"
+
+struct GrooveSearchResult
+{
+    juce::File file;
+    bool isFolder = false;
+    float score = 0.0f;
+};
+
+/**
+ * In-memory trigram index over the names of every indexed file and folder,
+ * plus tags derived from the library index (BPM, drum parts, source library).
+ *
+ * The index is rebuilt on a background thread whenever the library index
+ * publishes a new snapshot. Documents whose path and modification time are
+ * unchanged keep their tokenised text and trigrams, so a rebuild after a small
+ * change only re-tokenises what changed. Queries run against an immutable
+ * table and never block on a rebuild.
+ */
+class GrooveSearchIndex : public juce::ChangeBroadcaster,
+                          private juce::ChangeListener
+{
+public:
+    explicit GrooveSearchIndex(GrooveLibraryIndex& libraryIndex);
+    ~GrooveSearchIndex() override;
+
+    // Ranked matches for a free-text query, best first. Misspelt words still
+    // match as long as most of their trigrams do.
+    std::vector<GrooveSearchResult> search(const juce::String& query, int maxResults = 200) const;
+
+    int getNumEntries() const;
+
+private:
+    class BuildThread;
+    struct Table;
+
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    void publish(std::shared_ptr<const Table> newTable);
+
+    GrooveLibraryIndex& libraryIndex;
+
+    std::shared_ptr<const Table> table;
+    juce::CriticalSection tableLock;
+
+    std::unique_ptr<BuildThread> buildThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GrooveSearchIndex)
+};
@@ -0,0 +1,348 @@
+#include "GrooveThumbnailCache.h"
+#include <cstring>
+
+namespace
+{
+    constexpr juce::uint32 atlasMagic = 0x41544744;   // "DGTA" read in native (little endian) order
+    constexpr juce::uint32 atlasVersion = 1;
+
+    constexpr int stepsShown = 16;                   // 16th notes per bar
+    constexpr int barsShown = 2;                     // One lane per bar
+    constexpr int thumbnailsPerBatch = 256;          // Rendered between change messages
+
+    struct AtlasHeader
+    {
+        juce::uint32 magic;
+        juce::uint32 version;
+        juce::uint32 tileWidth;
+        juce::uint32 tileHeight;
+        juce::uint64 numTiles;
+        // Followed by uint64 hashes[numTiles] and uint8 pixels[numTiles][tileHeight][tileWidth]
+    };
+
+    int getLaneCount(const RhythmFeatures& features) noexcept
+    {
+        return juce::jlimit(1, barsShown, static_cast<int>(features.barCount));
+    }
+}
+
+//==============================================================================
+class GrooveThumbnailCache::RenderThread : public juce::Thread
+{
+public:
+    explicit RenderThread(GrooveThumbnailCache& o)
+        : juce::Thread("GrooveThumbnailCache render"), owner(o)
+    {
+    }
+
+    void run() override
+    {
+        owner.loadAtlas();
+        owner.sendChangeMessage();
+
+        while (!threadShouldExit())
+        {
+            auto snapshot = owner.libraryIndex.getSnapshot();
+
+            if (renderMissing(*snapshot) > 0 && !threadShouldExit())
+                owner.saveAtlas();
+
+            // Woken by notify() when the library index publishes again
+            wait(-1);
+        }
+    }
+
+private:
+    int renderMissing(const GrooveLibraryIndex::Snapshot& snapshot)
+    {
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+        std::vector<juce::uint8> pixels(static_cast<size_t>(tileSize));
+        int rendered = 0;
+
+        for (int row = 0; row < snapshot.size() && !threadShouldExit(); ++row)
+        {
+            const auto& features = snapshot.getFeatures(row);
+            const auto contentHash = getContentHash(features);
+
+            if (contentHash == 0 || owner.contains(contentHash))
+                continue;
+
+            renderTile(features, pixels.data());
+            owner.addTile(contentHash, pixels.data());
+
+            if (++rendered % thumbnailsPerBatch == 0)
+                owner.sendChangeMessage();
+        }
+
+        if (rendered > 0)
+        {
+            owner.sendChangeMessage();
+            DBG("GrooveThumbnailCache: Rendered " + juce::String(rendered) + " thumbnails in "
+                + juce::String(juce::Time::getMillisecondCounterHiRes() - startTime, 1) + " ms");
+        }
+
+        return rendered;
+    }
+
+    GrooveThumbnailCache& owner;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RenderThread)
+};
+
+//==============================================================================
+GrooveThumbnailCache::GrooveThumbnailCache(GrooveLibraryIndex& index)
+    : libraryIndex(index)
+{
+    renderThread = std::make_unique<RenderThread>(*this);
+    renderThread->startThread(juce::Thread::Priority::low);
+
+    libraryIndex.addChangeListener(this);
+}
+
+GrooveThumbnailCache::~GrooveThumbnailCache()
+{
+    libraryIndex.removeChangeListener(this);
+    renderThread->stopThread(4000);
+}
+
+void GrooveThumbnailCache::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    renderThread->notify();
+}
+
+juce::File GrooveThumbnailCache::getAtlasFile()
+{
+    return GrooveLibraryIndex::getIndexFile().getSiblingFile("thumbnails.atlas");
+}
+
+juce::uint64 GrooveThumbnailCache::getContentHash(const RhythmFeatures& features) noexcept
+{
+    if (features.hitCount == 0)
+        return 0;
+
+    // FNV-1a, 64 bit, over exactly what the thumbnail shows
+    juce::uint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](juce::uint32 value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    const int lanes = getLaneCount(features);
+    mix(static_cast<juce::uint32>(lanes));
+    for (int bar = 0; bar < lanes; ++bar)
+        mix(RhythmFeatures::getSixteenthMask(features.onsetMask[bar]));
+
+    return hash != 0 ? hash : 1;
+}
+
+void GrooveThumbnailCache::renderTile(const RhythmFeatures& features, juce::uint8* pixels)
+{
+    std::memset(pixels, 0, static_cast<size_t>(tileSize));
+
+    auto plot = [pixels](int x, int y, juce::uint8 alpha)
+    {
+        if (x >= 0 && x < thumbnailWidth && y >= 0 && y < thumbnailHeight)
+            pixels[y * thumbnailWidth + x] = alpha;
+    };
+
+    // Same look as the part rows: a lit dot per 16th with an onset, a faint one otherwise
+    const int lanes = getLaneCount(features);
+    const int laneHeight = thumbnailHeight / lanes;
+    const int stepWidth = thumbnailWidth / stepsShown;
+
+    for (int lane = 0; lane < lanes; ++lane)
+    {
+        const auto mask = RhythmFeatures::getSixteenthMask(features.onsetMask[lane]);
+        const int centreY = lane * laneHeight + laneHeight / 2;
+
+        for (int step = 0; step < stepsShown; ++step)
+        {
+            const int centreX = step * stepWidth + stepWidth / 2;
+
+            if ((mask >> step) & 1u)
+            {
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx)
+                        plot(centreX + dx, centreY + dy, (dx != 0 && dy != 0) ? 140 : 255);
+            }
+            else
+            {
+                plot(centreX, centreY, (step % 4 == 0) ? 110 : 60);
+            }
+        }
+    }
+}
+
+bool GrooveThumbnailCache::contains(juce::uint64 contentHash) const
+{
+    const juce::ScopedLock sl(atlasLock);
+    return slots.find(contentHash) != slots.end();
+}
+
+void GrooveThumbnailCache::addTile(juce::uint64 contentHash, const juce::uint8* pixels)
+{
+    const juce::ScopedLock sl(atlasLock);
+
+    if (slots.find(contentHash) != slots.end())
+        return;
+
+    const int slot = static_cast<int>(tileHashes.size());
+    const int pageIndex = slot / tilesPerPage;
+    const int tileInPage = slot % tilesPerPage;
+
+    if (pageIndex == static_cast<int>(pages.size()))
+    {
+        pages.emplace_back(juce::Image::SingleChannel,
+                           tilesPerRow * thumbnailWidth, (tilesPerPage / tilesPerRow) * thumbnailHeight,
+                           true, juce::SoftwareImageType());
+    }
+
+    // Written once, before the tile becomes visible through slots
+    juce::Image::BitmapData data(pages[static_cast<size_t>(pageIndex)],
+                                 (tileInPage % tilesPerRow) * thumbnailWidth,
+                                 (tileInPage / tilesPerRow) * thumbnailHeight,
+                                 thumbnailWidth, thumbnailHeight,
+                                 juce::Image::BitmapData::writeOnly);
+
+    for (int y = 0; y < thumbnailHeight; ++y)
+    {
+        auto* line = data.getLinePointer(y);
+        for (int x = 0; x < thumbnailWidth; ++x)
+            line[x * data.pixelStride] = pixels[y * thumbnailWidth + x];
+    }
+
+    tileHashes.push_back(contentHash);
+    slots.emplace(contentHash, slot);
+}
+
+bool GrooveThumbnailCache::draw(juce::Graphics& g, juce::uint64 contentHash, juce::Rectangle<int> area) const
+{
+    juce::Image page;
+    int slot = 0;
+
+    {
+        const juce::ScopedLock sl(atlasLock);
+
+        const auto found = slots.find(contentHash);
+        if (found == slots.end())
+            return false;
+
+        slot = found->second;
+        page = pages[static_cast<size_t>(slot / tilesPerPage)];
+    }
+
+    const int tileInPage = slot % tilesPerPage;
+    g.drawImage(page, area.getX(), area.getY(), area.getWidth(), area.getHeight(),
+                (tileInPage % tilesPerRow) * thumbnailWidth, (tileInPage / tilesPerRow) * thumbnailHeight,
+                thumbnailWidth, thumbnailHeight, true);
+    return true;
+}
+
+int GrooveThumbnailCache::getNumThumbnails() const
+{
+    const juce::ScopedLock sl(atlasLock);
+    return static_cast<int>(tileHashes.size());
+}
+
+//==============================================================================
+bool GrooveThumbnailCache::loadAtlas()
+{
+    const auto file = getAtlasFile();
+    if (!file.existsAsFile())
+        return false;
+
+    juce::MemoryBlock data;
+    if (!file.loadFileAsData(data) || data.getSize() < sizeof(AtlasHeader))
+        return false;
+
+    AtlasHeader header;
+    std::memcpy(&header, data.getData(), sizeof(header));
+
+    if (header.magic != atlasMagic || header.version != atlasVersion
+        || header.tileWidth != static_cast<juce::uint32>(thumbnailWidth)
+        || header.tileHeight != static_cast<juce::uint32>(thumbnailHeight))
+    {
+        DBG("GrooveThumbnailCache: Ignoring outdated " + file.getFullPathName());
+        return false;
+    }
+
+    const auto numTiles = header.numTiles;
+    const auto expectedSize = sizeof(AtlasHeader) + numTiles * (sizeof(juce::uint64) + static_cast<juce::uint64>(tileSize));
+    if (data.getSize() != expectedSize)
+    {
+        DBG("GrooveThumbnailCache: Truncated " + file.getFullPathName());
+        return false;
+    }
+
+    const auto* bytes = static_cast<const juce::uint8*>(data.getData());
+    const auto* hashes = bytes + sizeof(AtlasHeader);
+    const auto* pixels = hashes + numTiles * sizeof(juce::uint64);
+
+    for (juce::uint64 i = 0; i < numTiles; ++i)
+    {
+        juce::uint64 contentHash;
+        std::memcpy(&contentHash, hashes + i * sizeof(juce::uint64), sizeof(contentHash));
+        addTile(contentHash, pixels + i * static_cast<juce::uint64>(tileSize));
+    }
+
+    DBG("GrooveThumbnailCache: Loaded " + juce::String(static_cast<juce::int64>(numTiles)) + " thumbnails");
+    return true;
+}
+
+bool GrooveThumbnailCache::saveAtlas() const
+{
+    juce::MemoryOutputStream out;
+
+    {
+        const juce::ScopedLock sl(atlasLock);
+
+        AtlasHeader header {};
+        header.magic = atlasMagic;
+        header.version = atlasVersion;
+        header.tileWidth = static_cast<juce::uint32>(thumbnailWidth);
+        header.tileHeight = static_cast<juce::uint32>(thumbnailHeight);
+        header.numTiles = tileHashes.size();
+
+        out.preallocate(sizeof(header) + tileHashes.size() * (sizeof(juce::uint64) + static_cast<size_t>(tileSize)));
+        out.write(&header, sizeof(header));
+        out.write(tileHashes.data(), tileHashes.size() * sizeof(juce::uint64));
+
+        std::vector<juce::uint8> tile(static_cast<size_t>(tileSize));
+
+        for (size_t slot = 0; slot < tileHashes.size(); ++slot)
+        {
+            const int tileInPage = static_cast<int>(slot) % tilesPerPage;
+            const juce::Image::BitmapData data(pages[slot / tilesPerPage],
+                                               (tileInPage % tilesPerRow) * thumbnailWidth,
+                                               (tileInPage / tilesPerRow) * thumbnailHeight,
+                                               thumbnailWidth, thumbnailHeight);
+
+            for (int y = 0; y < thumbnailHeight; ++y)
+            {
+                const auto* line = data.getLinePointer(y);
+                for (int x = 0; x < thumbnailWidth; ++x)
+                    tile[static_cast<size_t>(y * thumbnailWidth + x)] = line[x * data.pixelStride];
+            }
+
+            out.write(tile.data(), tile.size());
+        }
+    }
+
+    const auto file = getAtlasFile();
+    file.getParentDirectory().createDirectory();
+
+    juce::TemporaryFile temp(file);
+
+    if (!temp.getFile().replaceWithData(out.getData(), out.getDataSize()) || !temp.overwriteTargetFileWithTemporary())
+    {
+        DBG("GrooveThumbnailCache: Failed to write " + file.getFullPathName());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <juce_graphics/juce_graphics.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "GrooveLibraryIndex.h"
+
+/**
+ * Small pattern thumbnails for the browser rows, drawn from the onset masks in
+ * the library index.
+ *
+ * Thumbnails are keyed by a hash of the onsets they show, so grooves with the
+ * same pattern share one. They are rendered on a background thread whenever
+ * the library index publishes, packed into single-channel atlas pages and kept
+ * in thumbnails.atlas next to the index, so a restart renders nothing that was
+ * seen before. Drawing only blits from the atlas and never renders.
+ */
+class GrooveThumbnailCache : public juce::ChangeBroadcaster,
+                             private juce::ChangeListener
+{
+public:
+    static constexpr int thumbnailWidth = 64;
+    static constexpr int thumbnailHeight = 12;
+
+    explicit GrooveThumbnailCache(GrooveLibraryIndex& libraryIndex);
+    ~GrooveThumbnailCache() override;
+
+    // Key of the thumbnail for these features, 0 if there is nothing to show
+    static juce::uint64 getContentHash(const RhythmFeatures& features) noexcept;
+
+    // Fills the thumbnail's shape with the current colour. Returns false if it
+    // hasn't been rendered yet; a change message follows once it has.
+    bool draw(juce::Graphics& g, juce::uint64 contentHash, juce::Rectangle<int> area) const;
+
+    int getNumThumbnails() const;
+
+    static juce::File getAtlasFile();
+
+private:
+    class RenderThread;
+
+    static constexpr int tilesPerRow = 16;
+    static constexpr int tilesPerPage = tilesPerRow * 32;
+    static constexpr int tileSize = thumbnailWidth * thumbnailHeight;
+
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+
+    bool contains(juce::uint64 contentHash) const;
+    void addTile(juce::uint64 contentHash, const juce::uint8* pixels);
+    static void renderTile(const RhythmFeatures& features, juce::uint8* pixels);
+
+    bool loadAtlas();
+    bool saveAtlas() const;
+
+    GrooveLibraryIndex& libraryIndex;
+
+    std::unordered_map<juce::uint64, int> slots;   // Content hash -> tile
+    std::vector<juce::uint64> tileHashes;          // Tile -> content hash
+    std::vector<juce::Image> pages;
+    juce::CriticalSection atlasLock;
+
+    std::unique_ptr<RenderThread> renderThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GrooveThumbnailCache)
+};
@@ -0,0 +1,236 @@
+#include "GrooveUsageTracker.h"
+#include "DissectionCache.h"
+#include "GrooveLibraryIndex.h"
+#include <algorithm>
+#include <vector>
+
+//==============================================================================
+class GrooveUsageTracker::WarmThread : public juce::Thread
+{
+public:
+    struct Item
+    {
+        juce::File file;
+        DrumLibrary sourceLibrary;
+    };
+
+    WarmThread(DissectionCache& cache, std::vector<Item> itemsToWarm, DrumLibrary target)
+        : juce::Thread("GrooveUsageTracker warm-up"), dissectionCache(cache),
+          items(std::move(itemsToWarm)), targetLibrary(target)
+    {
+    }
+
+    void run() override
+    {
+        const auto startTime = juce::Time::getMillisecondCounterHiRes();
+        const size_t budget = dissectionCache.getMemoryLimit() / 4 * 3;
+        int warmed = 0;
+
+        for (const auto& item : items)
+        {
+            if (threadShouldExit() || dissectionCache.getMemoryUsage() >= budget)
+                break;
+
+            if (!dissectionCache.getDrumParts(item.file, item.sourceLibrary, targetLibrary).isEmpty())
+                ++warmed;
+        }
+
+        DBG("GrooveUsageTracker: Warmed " + juce::String(warmed) + " of " + juce::String(static_cast<int>(items.size()))
+            + " grooves in " + juce::String(juce::Time::getMillisecondCounterHiRes() - startTime, 1) + " ms");
+    }
+
+private:
+    DissectionCache& dissectionCache;
+    const std::vector<Item> items;
+    const DrumLibrary targetLibrary;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WarmThread)
+};
+
+//==============================================================================
+GrooveUsageTracker::GrooveUsageTracker(const DrumLibraryManager& manager, DissectionCache& cache)
+    : libraryManager(manager), dissectionCache(cache)
+{
+    load();
+}
+
+GrooveUsageTracker::~GrooveUsageTracker()
+{
+    if (warmThread != nullptr)
+        warmThread->stopThread(4000);
+
+    stopTimer();
+
+    if (isDirty)
+        save();
+}
+
+void GrooveUsageTracker::recordUse(const juce::File& file, Action action)
+{
+    auto& entry = usage[file.getFullPathName()];
+
+    if (action == Action::Audition)
+        ++entry.auditions;
+    else
+        ++entry.drops;
+
+    entry.lastUsed = juce::Time::currentTimeMillis();
+
+    // A burst of auditions is written once
+    isDirty = true;
+    startTimer(saveDelayMs);
+}
+
+GrooveUsageTracker::Usage GrooveUsageTracker::getUsage(const juce::File& file) const
+{
+    const auto found = usage.find(file.getFullPathName());
+    return found != usage.end() ? found->second : Usage();
+}
+
+juce::Array<juce::File> GrooveUsageTracker::getWarmList(int maxRecent, int maxMostUsed) const
+{
+    std::vector<const std::pair<const juce::String, Usage>*> entries;
+    entries.reserve(usage.size());
+    for (const auto& entry : usage)
+        entries.push_back(&entry);
+
+    juce::StringArray paths;
+
+    auto takeFirst = [&entries, &paths](int count, auto isBefore)
+    {
+        const auto end = entries.begin() + std::min(entries.size(), static_cast<size_t>(count) + static_cast<size_t>(paths.size()));
+        std::partial_sort(entries.begin(), end, entries.end(), isBefore);
+
+        for (auto it = entries.begin(); it != end && count > 0; ++it)
+        {
+            if (!paths.contains((*it)->first))
+            {
+                paths.add((*it)->first);
+                --count;
+            }
+        }
+    };
+
+    takeFirst(maxRecent, [](const auto* a, const auto* b) { return a->second.lastUsed > b->second.lastUsed; });
+
+    // Drops count double: a groove that made it into the arrangement is likely to come back
+    takeFirst(maxMostUsed, [](const auto* a, const auto* b)
+    {
+        return a->second.auditions + 2 * a->second.drops > b->second.auditions + 2 * b->second.drops;
+    });
+
+    juce::Array<juce::File> files;
+    for (const auto& path : paths)
+        files.add(juce::File(path));
+
+    return files;
+}
+
+void GrooveUsageTracker::warmUp(DrumLibrary targetLibrary)
+{
+    if (warmThread != nullptr)
+        warmThread->stopThread(2000);
+
+    // Source libraries are looked up here, on the message thread, where the root folders live
+    std::vector<WarmThread::Item> items;
+    for (const auto& file : getWarmList(numRecentToWarm, numMostUsedToWarm))
+    {
+        if (file.existsAsFile())
+            items.push_back({ file, libraryManager.getSourceLibraryFor(file) });
+    }
+
+    if (items.empty())
+        return;
+
+    warmThread = std::make_unique<WarmThread>(dissectionCache, std::move(items), targetLibrary);
+    warmThread->startThread(juce::Thread::Priority::low);
+}
+
+juce::File GrooveUsageTracker::getUsageFile()
+{
+    return GrooveLibraryIndex::getIndexFile().getSiblingFile("usage.xml");
+}
+
+void GrooveUsageTracker::timerCallback()
+{
+    stopTimer();
+    save();
+}
+
+void GrooveUsageTracker::load()
+{
+    const auto file = getUsageFile();
+    if (!file.existsAsFile())
+        return;
+
+    auto xml = juce::parseXML(file);
+    if (xml == nullptr || !xml->hasTagName("Usage"))
+    {
+        DBG("GrooveUsageTracker: Ignoring unreadable " + file.getFullPathName());
+        return;
+    }
+
+    for (auto* entryXml : xml->getChildWithTagNameIterator("File"))
+    {
+        Usage entry;
+        entry.auditions = entryXml->getIntAttribute("auditions");
+        entry.drops = entryXml->getIntAttribute("drops");
+        entry.lastUsed = entryXml->getStringAttribute("lastUsed").getLargeIntValue();
+        usage[entryXml->getStringAttribute("path")] = entry;
+    }
+}
+
+void GrooveUsageTracker::trim()
+{
+    // Files that left the library; skipped while the index hasn't been loaded yet
+    const auto snapshot = libraryManager.getLibraryIndex().getSnapshot();
+    if (snapshot->size() > 0)
+    {
+        for (auto it = usage.begin(); it != usage.end();)
+        {
+            if (snapshot->indexOf(juce::File(it->first)) < 0)
+                it = usage.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    if (usage.size() <= maxEntries)
+        return;
+
+    // Trimmed below the limit, so the next few saves don't have to trim again
+    constexpr int numToKeepEach = static_cast<int>(maxEntries * 3 / 8);
+
+    std::map<juce::String, Usage> kept;
+    for (const auto& file : getWarmList(numToKeepEach, numToKeepEach))
+    {
+        const auto path = file.getFullPathName();
+        kept[path] = usage[path];
+    }
+
+    usage = std::move(kept);
+}
+
+void GrooveUsageTracker::save()
+{
+    trim();
+
+    juce::XmlElement xml("Usage");
+
+    for (const auto& [path, entry] : usage)
+    {
+        auto* entryXml = xml.createNewChildElement("File");
+        entryXml->setAttribute("path", path);
+        entryXml->setAttribute("auditions", entry.auditions);
+        entryXml->setAttribute("drops", entry.drops);
+        entryXml->setAttribute("lastUsed", juce::String(entry.lastUsed));
+    }
+
+    const auto file = getUsageFile();
+    file.getParentDirectory().createDirectory();
+
+    if (!xml.writeTo(file))
+        DBG("GrooveUsageTracker: Failed to write " + file.getFullPathName());
+
+    isDirty = false;
+}
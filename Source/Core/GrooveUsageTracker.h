@@ -0,0 +1,71 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <map>
+#include <memory>
+#include "DrumLibraryManager.h"
+
+class DissectionCache;
+
+/**
+ * Counts how often each groove is auditioned and dropped onto a track, and
+ * when it was last used.
+ *
+ * When the editor opens, warmUp() dissects the most recent and most used
+ * grooves into the shared dissection cache on a background thread, so the
+ * first audition of a session is served from memory like any later one.
+ * Warming stops at three quarters of the cache's memory limit, leaving room
+ * for what the user browses next. Usage is kept in usage.xml next to the
+ * library index, written once usage has been quiet for a while, and limited
+ * to the most recent and most used grooves that are still in the index.
+ */
+class GrooveUsageTracker : private juce::Timer
+{
+public:
+    enum class Action { Audition, Drop };
+
+    struct Usage
+    {
+        int auditions = 0;
+        int drops = 0;
+        juce::int64 lastUsed = 0;     // Milliseconds since the epoch
+    };
+
+    GrooveUsageTracker(const DrumLibraryManager& libraryManager, DissectionCache& dissectionCache);
+    ~GrooveUsageTracker() override;
+
+    void recordUse(const juce::File& file, Action action);
+    Usage getUsage(const juce::File& file) const;
+
+    // Most recent first, then the most used ones that weren't listed yet
+    juce::Array<juce::File> getWarmList(int maxRecent, int maxMostUsed) const;
+
+    // Dissects the warm list for targetLibrary in the background, replacing any warm-up in progress
+    void warmUp(DrumLibrary targetLibrary);
+
+    static juce::File getUsageFile();
+
+private:
+    class WarmThread;
+
+    static constexpr int saveDelayMs = 30000;
+    static constexpr size_t maxEntries = 2000;    // Beyond this only the most recent and most used are kept
+    static constexpr int numRecentToWarm = 16;
+    static constexpr int numMostUsedToWarm = 16;
+
+    void timerCallback() override;
+    void load();
+    void save();
+    void trim();
+
+    const DrumLibraryManager& libraryManager;
+    DissectionCache& dissectionCache;
+
+    std::map<juce::String, Usage> usage;   // Full path -> usage
+    bool isDirty = false;
+
+    std::unique_ptr<WarmThread> warmThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GrooveUsageTracker)
+};
@@ -1,4 +1,6 @@
 #include "MidiDissector.h"
+#include "DrumPartTables.h"
+#include <map>
 
 MidiDissector::MidiDissector()
 {
@@ -9,85 +11,41 @@ MidiDissector::~MidiDissector() = default;
 
 DrumPartType MidiDissector::getPartTypeFromNote(uint8_t midiNote, DrumLibrary sourceLibrary)
 {
-    // Library-specific mappings FIRST
-    switch (sourceLibrary)
-    {
-        case DrumLibrary::Ugritone:
-            switch (midiNote)
-            {
-                // Kicks
-                case 35: case 36: return DrumPartType::Kick;
-                
-                // Snares
-                case 37: case 38: case 40: return DrumPartType::Snare;
-                
-                // Hi-hats - Ugritone custom notes!
-                case 22: case 42: case 44: return DrumPartType::HiHatClosed;
-                case 26: case 46: return DrumPartType::HiHatOpen;
-                
-                // Toms
-                case 45: case 47: return DrumPartType::Tom1;
-                case 48: case 50: return DrumPartType::Tom2;
-                case 41: case 43: return DrumPartType::FloorTom;
-                
-                // Cymbals
-                case 49: case 52: case 55: case 57: return DrumPartType::Crash;
-                case 51: case 53: case 59: return DrumPartType::Ride;
-                
-                // Percussion
-                case 39: return DrumPartType::Clap;
-                case 56: return DrumPartType::Cowbell;
-                case 54: case 58: return DrumPartType::Shaker;
-                
-                default: break;
-            }
-            break;
-            
-        case DrumLibrary::EZdrummer:
-            switch (midiNote)
-            {
-                case 24: case 36: return DrumPartType::Kick;
-                case 26: case 38: return DrumPartType::Snare;
-                default: break;
-            }
-            break;
-            
-        default:
-            break;
-    }
+    // Library-specific tables already fall back to General MIDI for notes they don't override
+    return DrumPartTables::getPartTable(sourceLibrary)[midiNote & 0x7f];
+}
+
+DrumPartType MidiDissector::classifySourceNote(uint8_t midiNote, DrumLibrary sourceLibrary,
+                                               const DrumLibraryManager& libraryManager)
+{
+    return buildSourcePartTable(sourceLibrary, libraryManager)[midiNote & 0x7f];
+}
+
+std::array<DrumPartType, 128> MidiDissector::buildSourcePartTable(DrumLibrary sourceLibrary,
+                                                                   const DrumLibraryManager& libraryManager)
+{
+    // If the source library has a General MIDI mapping for a note, classify by its GM meaning,
+    // otherwise fall back to the library's own table
+    const auto& toGeneralMidi = libraryManager.getNoteMap(sourceLibrary, DrumLibrary::GeneralMIDI);
+    const auto& libraryTable = DrumPartTables::getPartTable(sourceLibrary);
+    
+    std::array<DrumPartType, 128> table {};
     
-    // Standard General MIDI mappings
-    switch (midiNote)
+    for (size_t note = 0; note < table.size(); ++note)
     {
-        // Kicks
-        case 35: case 36: return DrumPartType::Kick;
-        
-        // Snares  
-        case 38: case 40: return DrumPartType::Snare;
-        
-        // Hi-hats
-        case 42: case 44: return DrumPartType::HiHatClosed;
-        case 46: return DrumPartType::HiHatOpen;
-        
-        // Crashes
-        case 49: case 57: return DrumPartType::Crash;
-        
-        // Ride
-        case 51: case 59: return DrumPartType::Ride;
-        
-        // Toms
-        case 45: case 47: return DrumPartType::Tom1;
-        case 48: case 50: return DrumPartType::Tom2;
-        case 41: case 43: return DrumPartType::FloorTom;
-        
-        // Percussion
-        case 39: return DrumPartType::Clap;
-        case 56: return DrumPartType::Cowbell;
-        case 69: case 70: return DrumPartType::Shaker;
-        
-        default:
-            return DrumPartType::Other;
+        const uint8_t gmNote = toGeneralMidi[note];
+        table[note] = (gmNote != note) ? DrumPartTables::generalMidi[gmNote & 0x7f]
+                                       : libraryTable[note];
     }
+    
+    return table;
+}
+
+void MidiDissector::classifyNotes(const uint8_t* notes, DrumPartType* partTypes, int numNotes,
+                                  const std::array<DrumPartType, 128>& partTable)
+{
+    for (int i = 0; i < numNotes; ++i)
+        partTypes[i] = partTable[notes[i] & 0x7f];
 }
 
 juce::Array<DrumPart> MidiDissector::dissectMidiFileWithLibraryManager(const juce::File& midiFile,
@@ -108,26 +66,24 @@ juce::Array<DrumPart> MidiDissector::dissectMidiFileWithLibraryManager(const juc
     if (!midiFileData.readFrom(inputStream))
         return parts;
     
-    // Handle Bypass mode: use General MIDI for dissection, but don't remap notes
-    DrumLibrary dissectionLibrary = sourceLibrary;
-	DrumLibrary remapTargetLibrary = targetLibrary;
+    // Parts are dissected on their source notes, then projected onto the target library
+    auto sourceParts = dissectSourceParts(midiFileData, sourceLibrary, libraryManager);
+    parts = remapDrumPartsToTarget(sourceParts, sourceLibrary, targetLibrary, libraryManager);
+    
+    DBG("MIDI Dissection complete: " + juce::String(parts.size()) + " parts found in " + 
+        midiFile.getFileName() + " (Source: " + juce::String(static_cast<int>(sourceLibrary)) + 
+        ", Target: " + juce::String(static_cast<int>(targetLibrary)) + 
+        (targetLibrary == DrumLibrary::Bypass ? " [Bypass Mode - No Remapping]" : "") + ")");
+    
+    return parts;
+}
 
-	if (targetLibrary == DrumLibrary::Bypass)
-	{
-		// In Bypass mode: use General MIDI for dissection/categorization (as requested)
-		dissectionLibrary = DrumLibrary::GeneralMIDI;
-    
-		// Don't remap notes - keep them as-is by using source library
-		if (sourceLibrary != DrumLibrary::Unknown)
-		{
-			remapTargetLibrary = sourceLibrary; // Use source to prevent remapping
-		}
-		else
-		{
-			// If source is unknown, assume General MIDI to prevent errors
-			remapTargetLibrary = DrumLibrary::GeneralMIDI;
-		}
-	}    
+juce::Array<DrumPart> MidiDissector::dissectSourceParts(const juce::MidiFile& midiFileData,
+                                                        DrumLibrary sourceLibrary,
+                                                        const DrumLibraryManager& libraryManager) const
+{
+    juce::Array<DrumPart> parts;
+    
     // Merge all tracks into one combined sequence
     juce::MidiMessageSequence combinedTrackSequence;
     
@@ -145,17 +101,13 @@ juce::Array<DrumPart> MidiDissector::dissectMidiFileWithLibraryManager(const juc
     
     combinedTrackSequence.sort();
     
-    // Analyze with library manager
-    // dissectionLibrary is used to identify what type of drum part each note represents
-    // remapTargetLibrary is used to remap the notes to the target library
-    analyzeSequence(combinedTrackSequence, parts, dissectionLibrary, remapTargetLibrary, &libraryManager);
+    // Timestamps are in ticks; SMPTE timed files fall back to the default resolution
+    const short timeFormat = midiFileData.getTimeFormat();
+    const double ticksPerQuarterNote = timeFormat > 0 ? static_cast<double>(timeFormat) : 480.0;
     
-    sortPartsByPriority(parts);
+    analyzeSequence(combinedTrackSequence, parts, sourceLibrary, libraryManager, ticksPerQuarterNote);
     
-    DBG("MIDI Dissection complete: " + juce::String(parts.size()) + " parts found in " + 
-        midiFile.getFileName() + " (Source: " + juce::String(static_cast<int>(sourceLibrary)) + 
-        ", Target: " + juce::String(static_cast<int>(targetLibrary)) + 
-        (targetLibrary == DrumLibrary::Bypass ? " [Bypass Mode - No Remapping]" : "") + ")");
+    sortPartsByPriority(parts);
     
     return parts;
 }
@@ -163,11 +115,18 @@ juce::Array<DrumPart> MidiDissector::dissectMidiFileWithLibraryManager(const juc
 void MidiDissector::analyzeSequence(const juce::MidiMessageSequence& sequence, 
                                    juce::Array<DrumPart>& parts, 
                                    DrumLibrary sourceLibrary,
-                                   DrumLibrary targetLibrary,
-                                   const DrumLibraryManager* libraryManager) const
+                                   const DrumLibraryManager& libraryManager,
+                                   double ticksPerQuarterNote) const
 {
     std::map<DrumPartType, DrumPart> partMap;
     
+    // Filled through writable handles; the parts only get const ones
+    std::vector<DrumPartData::Ptr> partData(static_cast<size_t>(DrumPartType::COUNT));
+    
+    // Rhythm features are accumulated in the same pass as the events
+    std::vector<RhythmFeatureBuilder> featureBuilders(static_cast<size_t>(DrumPartType::COUNT),
+                                                      RhythmFeatureBuilder(ticksPerQuarterNote));
+    
     // Initialize all possible parts
     for (int i = 0; i < static_cast<int>(DrumPartType::COUNT); ++i)
     {
@@ -179,78 +138,72 @@ void MidiDissector::analyzeSequence(const juce::MidiMessageSequence& sequence,
         part.colour = getPartColour(partType);
         part.eventCount = 0;
         part.duration = 0.0;
+        part.sourceLibrary = sourceLibrary;
+        partData[static_cast<size_t>(i)] = std::make_shared<DrumPartData>();
         partMap[partType] = part;
     }
     
-    // Process each MIDI event
+    // Classify every note event in one pass over the source table
+    const auto partTable = buildSourcePartTable(sourceLibrary, libraryManager);
+    
+    std::vector<int> noteEventIndices;
+    std::vector<uint8_t> noteNumbers;
+    noteEventIndices.reserve(static_cast<size_t>(sequence.getNumEvents()));
+    noteNumbers.reserve(static_cast<size_t>(sequence.getNumEvents()));
+    
     for (int i = 0; i < sequence.getNumEvents(); ++i)
     {
         const juce::MidiMessage& msg = sequence.getEventPointer(i)->message;
         
+        if (msg.isNoteOnOrOff())
+        {
+            noteEventIndices.push_back(i);
+            noteNumbers.push_back(static_cast<uint8_t>(msg.getNoteNumber()));
+        }
+    }
+    
+    std::vector<DrumPartType> partTypes(noteNumbers.size());
+    classifyNotes(noteNumbers.data(), partTypes.data(), static_cast<int>(noteNumbers.size()), partTable);
+    
+    // Process each note event - notes stay as they are in the source file
+    for (size_t n = 0; n < noteEventIndices.size(); ++n)
+    {
+        const juce::MidiMessage& msg = sequence.getEventPointer(noteEventIndices[n])->message;
+        const uint8_t originalNote = noteNumbers[n];
+        const DrumPartType partType = partTypes[n];
+        
+        if (partType == DrumPartType::Other && !isValidDrumNote(originalNote))
+            continue;
+        
+        auto& part = partMap[partType];
+        auto& data = *partData[static_cast<size_t>(partType)];
+        
         if (msg.isNoteOn() && msg.getVelocity() > 0)
         {
-            uint8_t originalNote = static_cast<uint8_t>(msg.getNoteNumber());
+            data.originalNotes.addIfNotAlreadyThere(originalNote);
+            data.remappedNotes.addIfNotAlreadyThere(originalNote);
             
-            // CRITICAL FIX: Remap note FIRST, then identify based on TARGET library
-            uint8_t finalNote = originalNote;
-            if (libraryManager && sourceLibrary != targetLibrary)
-            {
-                finalNote = libraryManager->mapNoteToLibrary(originalNote, sourceLibrary, targetLibrary);
-            }
+            juce::MidiMessage processedMsg = juce::MidiMessage::noteOn(
+                msg.getChannel(), 
+                originalNote, 
+                static_cast<juce::uint8>(msg.getVelocity()));
+            processedMsg.setTimeStamp(msg.getTimeStamp());
             
-            // Determine part type using TARGET library (so we see what it means in target context)
-            DrumPartType partType = getPartTypeFromNote(finalNote, targetLibrary);
+            data.sequence.addEvent(processedMsg);
+            part.eventCount++;
             
-            if (partType != DrumPartType::Other || isValidDrumNote(originalNote))
-            {
-                auto& part = partMap[partType];
-                
-                // Store original note
-                part.originalNotes.addIfNotAlreadyThere(originalNote);
-                
-                // Store remapped note
-                part.remappedNotes.addIfNotAlreadyThere(finalNote);
-                
-                // Create processed message with remapped note
-                juce::MidiMessage processedMsg = juce::MidiMessage::noteOn(
-                    msg.getChannel(), 
-                    finalNote, 
-                    static_cast<juce::uint8>(msg.getVelocity()));
-                processedMsg.setTimeStamp(msg.getTimeStamp());
-                
-                // Add to sequence
-                part.sequence.addEvent(processedMsg);
-                part.eventCount++;
-                
-                // Update duration
-                if (msg.getTimeStamp() > part.duration)
-                    part.duration = msg.getTimeStamp();
-            }
+            featureBuilders[static_cast<size_t>(partType)].addOnset(msg.getTimeStamp(), msg.getVelocity());
+            
+            // Update duration
+            if (msg.getTimeStamp() > part.duration)
+                part.duration = msg.getTimeStamp();
         }
         else if (msg.isNoteOff())
         {
-            uint8_t originalNote = static_cast<uint8_t>(msg.getNoteNumber());
+            juce::MidiMessage processedMsg = juce::MidiMessage::noteOff(msg.getChannel(), originalNote);
+            processedMsg.setTimeStamp(msg.getTimeStamp());
             
-            // Remap note first
-            uint8_t finalNote = originalNote;
-            if (libraryManager && sourceLibrary != targetLibrary)
-            {
-                finalNote = libraryManager->mapNoteToLibrary(originalNote, sourceLibrary, targetLibrary);
-            }
-            
-            // Identify using target library
-            DrumPartType partType = getPartTypeFromNote(finalNote, targetLibrary);
-            
-            if (partType != DrumPartType::Other || isValidDrumNote(originalNote))
-            {
-                auto& part = partMap[partType];
-                
-                // Create note-off with remapped note
-                juce::MidiMessage processedMsg = juce::MidiMessage::noteOff(msg.getChannel(), finalNote);
-                processedMsg.setTimeStamp(msg.getTimeStamp());
-                
-                part.sequence.addEvent(processedMsg);
-            }
+            data.sequence.addEvent(processedMsg);
         }
     }
     
@@ -259,80 +212,232 @@ void MidiDissector::analyzeSequence(const juce::MidiMessageSequence& sequence,
     {
         if (part.eventCount > 0)
         {
-            part.sequence.sort();
-            part.sequence.updateMatchedPairs();
+            auto& data = partData[static_cast<size_t>(type)];
+            data->sequence.sort();
+            data->sequence.updateMatchedPairs();
+            part.data = data;
+            part.features = featureBuilders[static_cast<size_t>(type)].build();
             parts.add(part);
         }
     }
 }
 
-juce::Array<DrumPart> MidiDissector::remapDrumPartsToTarget(const juce::Array<DrumPart>& originalParts,
-                                                            DrumLibrary sourceLibrary,
-                                                            DrumLibrary newTargetLibrary,
-                                                            const DrumLibraryManager& libraryManager)
+GrooveFingerprint MidiDissector::computeFingerprint(const juce::Array<DrumPart>& parts)
 {
-    juce::Array<DrumPart> remappedParts;
+    GrooveFingerprint fingerprint;
     
-    for (const auto& originalPart : originalParts)
+    // Every part repeats over the groove's length, not its own
+    int grooveBars = 1;
+    for (const auto& part : parts)
+        grooveBars = juce::jmax(grooveBars, static_cast<int>(part.features.barCount));
+    grooveBars = juce::jmin(grooveBars, RhythmFeatures::maxBars);
+    
+    for (const auto& part : parts)
     {
-        DrumPart part = originalPart;
+        int lane = -1;
         
-        // Clear remapped notes
-        part.remappedNotes.clear();
+        switch (part.type)
+        {
+            case DrumPartType::Kick:        lane = GrooveFingerprint::kickLane; break;
+            case DrumPartType::Snare:
+            case DrumPartType::Clap:        lane = GrooveFingerprint::snareLane; break;
+            case DrumPartType::HiHatClosed:
+            case DrumPartType::HiHatOpen:
+            case DrumPartType::Ride:        lane = GrooveFingerprint::hiHatLane; break;
+            default:                        break;
+        }
         
-        // Create new sequence with remapped notes
-        juce::MidiMessageSequence newSequence;
+        if (lane < 0)
+            continue;
         
-        for (int i = 0; i < originalPart.sequence.getNumEvents(); ++i)
+        for (int bar = 0; bar < GrooveFingerprint::barsPerLane; ++bar)
         {
-            juce::MidiMessage message = originalPart.sequence.getEventPointer(i)->message;
+            const auto mask = RhythmFeatures::getSixteenthMask(part.features.onsetMask[bar % grooveBars]);
+            fingerprint.lanes[lane] |= static_cast<juce::uint64>(mask) << (bar * 16);
+        }
+    }
+    
+    return fingerprint;
+}
+
+bool MidiDissector::detectTimeSignature(const juce::Array<DrumPart>& parts, double ticksPerQuarterNote,
+                                        int& numerator, int& denominator)
+{
+    if (ticksPerQuarterNote <= 0.0)
+        return false;
+    
+    // Accent strength per 8th note; hi-hats and rides tick along in every meter
+    constexpr int maxEighths = 512;
+    const double ticksPerEighth = ticksPerQuarterNote / 2.0;
+    std::array<float, maxEighths> strength {};
+    int numEighths = 0;
+    
+    for (const auto& part : parts)
+    {
+        const float weight = part.type == DrumPartType::Kick  ? 1.0f
+                           : part.type == DrumPartType::Crash ? 1.5f
+                           : (part.type == DrumPartType::Snare || part.type == DrumPartType::Clap) ? 0.6f
+                                                                                                     : 0.0f;
+        if (weight == 0.0f)
+            continue;
+        
+        for (const auto* event : part.getSequence())
+        {
+            if (!event->message.isNoteOn())
+                continue;
             
-            if (message.isNoteOnOrOff())
-            {
-                uint8_t originalNote = static_cast<uint8_t>(message.getNoteNumber());
-                uint8_t remappedNote = libraryManager.mapNoteToLibrary(originalNote, sourceLibrary, newTargetLibrary);
-                
-                if (message.isNoteOn())
-                {
-                    message = juce::MidiMessage::noteOn(message.getChannel(), 
-                                                       remappedNote, 
-                                                       static_cast<juce::uint8>(message.getVelocity()));
-                    part.remappedNotes.addIfNotAlreadyThere(remappedNote);
-                }
-                else
-                {
-                    message = juce::MidiMessage::noteOff(message.getChannel(), remappedNote);
-                }
-                
-                message.setTimeStamp(originalPart.sequence.getEventPointer(i)->message.getTimeStamp());
-            }
+            const int eighth = juce::roundToInt(event->message.getTimeStamp() / ticksPerEighth);
+            if (eighth < 0 || eighth >= maxEighths)
+                continue;
             
-            newSequence.addEvent(message);
+            strength[static_cast<size_t>(eighth)] += weight * event->message.getFloatVelocity();
+            numEighths = juce::jmax(numEighths, eighth + 1);
         }
+    }
+    
+    // Bar lengths in 8ths, 4/4 first and then shortest first; 3/4 and 6/8 share one
+    // and are told apart by their accents
+    struct Candidate { int eighths, numerator, denominator; };
+    constexpr Candidate candidates[] = { { 8, 4, 4 }, { 5, 5, 8 }, { 6, 3, 4 }, { 7, 7, 8 }, { 9, 9, 8 }, { 10, 5, 4 } };
+    
+    auto periodicity = [&strength, numEighths](int lag)
+    {
+        float product = 0.0f, energy = 0.0f;
+        for (int i = 0; i + lag < numEighths; ++i)
+        {
+            product += strength[static_cast<size_t>(i)] * strength[static_cast<size_t>(i + lag)];
+            energy += strength[static_cast<size_t>(i)] * strength[static_cast<size_t>(i)];
+        }
+        return energy > 0.0f ? product / energy : 0.0f;
+    };
+    
+    // Two full bars at least, or the meter can't be heard
+    if (numEighths < 2 * candidates[0].eighths)
+        return false;
+    
+    const float commonTimeScore = periodicity(candidates[0].eighths);
+    const Candidate* best = nullptr;
+    float bestScore = commonTimeScore + 0.15f;
+    
+    for (const auto& candidate : candidates)
+    {
+        if (candidate.eighths == candidates[0].eighths || numEighths < 2 * candidate.eighths)
+            continue;
+        
+        // Shorter bars win near-ties, so 5/8 isn't reported as 5/4
+        const float score = periodicity(candidate.eighths);
+        if (best == nullptr ? score >= bestScore : score > bestScore + 0.02f)
+        {
+            best = &candidate;
+            bestScore = score;
+        }
+    }
+    
+    if (best == nullptr)
+        return false;
+    
+    numerator = best->numerator;
+    denominator = best->denominator;
+    
+    if (best->eighths == 6)
+    {
+        // Compound time accents the 4th 8th, simple time the 3rd and 5th
+        std::array<float, 6> profile {};
+        for (int i = 0; i < numEighths; ++i)
+            profile[static_cast<size_t>(i % 6)] += strength[static_cast<size_t>(i)];
         
-        part.sequence = newSequence;
-        part.sequence.sort();
-        part.sequence.updateMatchedPairs();
+        if (profile[3] > juce::jmax(profile[2], profile[4]))
+        {
+            numerator = 6;
+            denominator = 8;
+        }
+    }
+    
+    return true;
+}
+
+juce::uint64 MidiDissector::findFillBars(const juce::Array<DrumPart>& parts, double ticksPerBar)
+{
+    constexpr int maxFillBars = 64;
+    std::array<int, maxFillBars> hits {}, fillHits {};
+    
+    if (ticksPerBar <= 0.0)
+        return 0;
+    
+    const double downbeatTolerance = ticksPerBar / 32.0;
+    
+    for (const auto& part : parts)
+    {
+        const bool isTom = part.type == DrumPartType::Tom1 || part.type == DrumPartType::Tom2
+                        || part.type == DrumPartType::Tom3 || part.type == DrumPartType::FloorTom;
+        const bool isCrash = part.type == DrumPartType::Crash;
         
-        // Recalculate part type based on remapped notes in target library
-        if (!part.remappedNotes.isEmpty())
+        for (const auto* event : part.getSequence())
         {
-            DrumPartType newPartType = getPartTypeFromNote(part.remappedNotes[0], newTargetLibrary);
+            if (!event->message.isNoteOn())
+                continue;
             
-            if (newPartType != part.type)
-            {
-                part.type = newPartType;
-                part.name = getPartShortName(newPartType);
-                part.displayName = getPartDisplayName(newPartType);
-                part.colour = getPartColour(newPartType);
-            }
+            const double tick = event->message.getTimeStamp();
+            const int bar = static_cast<int>(tick / ticksPerBar);
+            if (bar < 0 || bar >= maxFillBars)
+                continue;
+            
+            ++hits[static_cast<size_t>(bar)];
+            
+            if (isTom || (isCrash && tick - bar * ticksPerBar > downbeatTolerance))
+                ++fillHits[static_cast<size_t>(bar)];
         }
+    }
+    
+    juce::uint64 fillBars = 0;
+    for (int bar = 0; bar < maxFillBars; ++bar)
+    {
+        const int fill = fillHits[static_cast<size_t>(bar)];
+        if (fill >= 3 && fill * 4 >= hits[static_cast<size_t>(bar)])
+            fillBars |= static_cast<juce::uint64>(1) << bar;
+    }
+    
+    return fillBars;
+}
+
+juce::Array<DrumPart> MidiDissector::remapDrumPartsToTarget(const juce::Array<DrumPart>& originalParts,
+                                                            DrumLibrary sourceLibrary,
+                                                            DrumLibrary newTargetLibrary,
+                                                            const DrumLibraryManager& libraryManager)
+{
+    // Bypass keeps the source notes untouched
+    if (newTargetLibrary == DrumLibrary::Bypass || newTargetLibrary == sourceLibrary)
+        return originalParts;
+    
+    const auto& noteMap = libraryManager.getNoteMap(sourceLibrary, newTargetLibrary);
+    
+    juce::Array<DrumPart> remappedParts;
+    remappedParts.ensureStorageAllocated(originalParts.size());
+    
+    for (const auto& originalPart : originalParts)
+    {
+        DrumPart part = originalPart;
+        
+        // Source data is shared and immutable - the projection gets its own copy
+        auto remapped = std::make_shared<DrumPartData>();
+        remapped->sequence = originalPart.getSequence();
+        remapped->originalNotes = originalPart.getOriginalNotes();
+        
+        for (auto note : remapped->originalNotes)
+            remapped->remappedNotes.addIfNotAlreadyThere(noteMap[static_cast<size_t>(note & 0x7f)]);
         
+        // Timing and note pairing are unchanged, so only the note numbers need rewriting
+        for (auto* event : remapped->sequence)
+        {
+            if (event->message.isNoteOnOrOff())
+                event->message.setNoteNumber(noteMap[static_cast<size_t>(event->message.getNoteNumber())]);
+        }
+        
+        // Part type stays canonical - it was classified on the source notes
+        part.data = std::move(remapped);
         remappedParts.add(part);
     }
     
-    sortPartsByPriority(remappedParts);
-    
     return remappedParts;
 }
 
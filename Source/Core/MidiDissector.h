@@ -4,6 +4,9 @@
 #include <juce_audio_formats/juce_audio_formats.h>
 #include <juce_graphics/juce_graphics.h>
 #include "DrumLibraryManager.h"
+#include "RhythmFeatures.h"
+#include <array>
+#include <memory>
 
 enum class DrumPartType
 {
@@ -24,18 +27,29 @@ enum class DrumPartType
     COUNT
 };
 
+// Event data of a drum part. Shared between DrumPart copies and never modified once
+// the part has been handed out by the dissector.
+struct DrumPartData
+{
+    using Ptr = std::shared_ptr<DrumPartData>;
+    using ConstPtr = std::shared_ptr<const DrumPartData>;
+    
+    juce::MidiMessageSequence sequence;
+    juce::Array<uint8_t> originalNotes;
+    juce::Array<uint8_t> remappedNotes;
+};
+
 struct DrumPart
 {
     DrumPartType type;
     juce::String name;
     juce::String displayName;
-    juce::MidiMessageSequence sequence;
-    juce::Array<uint8_t> originalNotes;
-    juce::Array<uint8_t> remappedNotes;
+    DrumPartData::ConstPtr data;   // Copying a part only copies this handle
     int eventCount = 0;
     double duration = 0.0;
     juce::Colour colour;
     DrumLibrary sourceLibrary = DrumLibrary::Unknown;  // NEW: Store source library
+    RhythmFeatures features;                           // Onset grid, density, velocity and swing
     
     // FIXED: Drag description includes source library
     juce::String getDragDescription(const juce::File& originalFile) const
@@ -47,6 +61,17 @@ struct DrumPart
     }
     
     bool hasEvents() const { return eventCount > 0; }
+    
+    const juce::MidiMessageSequence& getSequence() const  { return data != nullptr ? data->sequence : getEmptyData().sequence; }
+    const juce::Array<uint8_t>& getOriginalNotes() const  { return data != nullptr ? data->originalNotes : getEmptyData().originalNotes; }
+    const juce::Array<uint8_t>& getRemappedNotes() const  { return data != nullptr ? data->remappedNotes : getEmptyData().remappedNotes; }
+    
+private:
+    static const DrumPartData& getEmptyData()
+    {
+        static const DrumPartData empty;
+        return empty;
+    }
 };
 
 class MidiDissector
@@ -61,15 +86,43 @@ public:
                                                             DrumLibrary targetLibrary,
                                                             const DrumLibraryManager& libraryManager);
     
+    // Dissect an already parsed file into parts that keep their source notes (no target remapping)
+    juce::Array<DrumPart> dissectSourceParts(const juce::MidiFile& midiFileData,
+                                             DrumLibrary sourceLibrary,
+                                             const DrumLibraryManager& libraryManager) const;
+    
     // Remap existing parts to different target library
-    juce::Array<DrumPart> remapDrumPartsToTarget(const juce::Array<DrumPart>& originalParts,
-                                                  DrumLibrary sourceLibrary,
-                                                  DrumLibrary newTargetLibrary,
-                                                  const DrumLibraryManager& libraryManager);
+    static juce::Array<DrumPart> remapDrumPartsToTarget(const juce::Array<DrumPart>& originalParts,
+                                                        DrumLibrary sourceLibrary,
+                                                        DrumLibrary newTargetLibrary,
+                                                        const DrumLibraryManager& libraryManager);
     
     // Get part type from MIDI note considering source library
     static DrumPartType getPartTypeFromNote(uint8_t midiNote, DrumLibrary sourceLibrary = DrumLibrary::GeneralMIDI);
     
+    // Canonical part type of a source note: uses the General MIDI meaning when the library maps the note
+    static DrumPartType classifySourceNote(uint8_t midiNote, DrumLibrary sourceLibrary,
+                                           const DrumLibraryManager& libraryManager);
+    
+    // Full 128-note classification table for a source library (see classifySourceNote)
+    static std::array<DrumPartType, 128> buildSourcePartTable(DrumLibrary sourceLibrary,
+                                                              const DrumLibraryManager& libraryManager);
+    
+    // Batch classification of note numbers through a table from buildSourcePartTable
+    static void classifyNotes(const uint8_t* notes, DrumPartType* partTypes, int numNotes,
+                              const std::array<DrumPartType, 128>& partTable);
+    
+    // Similarity fingerprint of a groove from its dissected parts
+    static GrooveFingerprint computeFingerprint(const juce::Array<DrumPart>& parts);
+    
+    // Meter from how often the kick, snare and crash accents repeat. Leaves the
+    // arguments alone and returns false unless a meter stands out clearly from 4/4.
+    static bool detectTimeSignature(const juce::Array<DrumPart>& parts, double ticksPerQuarterNote,
+                                    int& numerator, int& denominator);
+    
+    // Bit n set = bar n is dense with toms or off-downbeat crashes, as in a fill
+    static juce::uint64 findFillBars(const juce::Array<DrumPart>& parts, double ticksPerBar);
+    
     // Display info for part types
     static juce::String getPartDisplayName(DrumPartType type);
     static juce::String getPartShortName(DrumPartType type);
@@ -79,8 +132,8 @@ private:
     void analyzeSequence(const juce::MidiMessageSequence& sequence, 
                         juce::Array<DrumPart>& parts, 
                         DrumLibrary sourceLibrary,
-                        DrumLibrary targetLibrary,
-                        const DrumLibraryManager* libraryManager) const;
+                        const DrumLibraryManager& libraryManager,
+                        double ticksPerQuarterNote) const;
     
     void initializeNoteMappings();
     
@@ -0,0 +1,210 @@
+#include "MidiFileCache.h"
+
+//==============================================================================
+class MidiFileCache::PrefetchThread : public juce::Thread
+{
+public:
+    explicit PrefetchThread(MidiFileCache& o)
+        : juce::Thread("MidiFileCache prefetch"), owner(o)
+    {
+    }
+
+    void add(const juce::Array<juce::File>& files)
+    {
+        {
+            const juce::ScopedLock sl(queueLock);
+            for (const auto& file : files)
+                queue.addIfNotAlreadyThere(file);
+        }
+
+        notify();
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            juce::File file;
+            bool hasFile = false;
+
+            {
+                const juce::ScopedLock sl(queueLock);
+                if (!queue.isEmpty())
+                {
+                    file = queue.removeAndReturn(0);
+                    hasFile = true;
+                }
+            }
+
+            if (!hasFile)
+            {
+                // Woken by notify() when more files are queued
+                wait(-1);
+                continue;
+            }
+
+            if (file.existsAsFile())
+                owner.fetch(file, false);
+        }
+    }
+
+private:
+    MidiFileCache& owner;
+    juce::Array<juce::File> queue;
+    juce::CriticalSection queueLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PrefetchThread)
+};
+
+//==============================================================================
+MidiFileCache::MidiFileCache()
+{
+    prefetchThread = std::make_unique<PrefetchThread>(*this);
+    prefetchThread->startThread(juce::Thread::Priority::low);
+}
+
+MidiFileCache::~MidiFileCache()
+{
+    prefetchThread->stopThread(4000);
+}
+
+MidiFileCache::Handle MidiFileCache::get(const juce::File& file)
+{
+    return fetch(file, true);
+}
+
+void MidiFileCache::prefetch(const juce::Array<juce::File>& files)
+{
+    prefetchThread->add(files);
+}
+
+MidiFileCache::Handle MidiFileCache::fetch(const juce::File& file, bool countRequest)
+{
+    const juce::String path = file.getFullPathName();
+    const juce::int64 size = file.getSize();
+    const juce::int64 modificationTime = file.getLastModificationTime().toMilliseconds();
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        auto entry = entries.find(path);
+        if (entry != entries.end() && entry->second.size == size && entry->second.modificationTime == modificationTime)
+        {
+            entry->second.lastUsed = ++useCounter;
+
+            if (countRequest)
+                ++numHits;
+
+            return entry->second.midiFile;
+        }
+
+        if (countRequest)
+            ++numMisses;
+    }
+
+    // Parsed outside the lock, so a slow read doesn't hold up cached requests
+    auto midiFile = std::make_shared<CompactMidiFile>();
+    if (!midiFile->load(file))
+    {
+        DBG("MidiFileCache: Failed to read " + path);
+        return nullptr;
+    }
+
+    const juce::ScopedLock sl(lock);
+
+    auto& entry = entries[path];
+    memoryUsed -= entry.bytes;
+    entry.size = size;
+    entry.modificationTime = modificationTime;
+    entry.midiFile = midiFile;
+    entry.bytes = estimateSize(*midiFile);
+    entry.lastUsed = ++useCounter;
+    memoryUsed += entry.bytes;
+
+    evictToMemoryLimit();
+    return midiFile;
+}
+
+void MidiFileCache::invalidate(const juce::File& file)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto entry = entries.find(file.getFullPathName());
+    if (entry != entries.end())
+    {
+        memoryUsed -= entry->second.bytes;
+        entries.erase(entry);
+    }
+}
+
+void MidiFileCache::clear()
+{
+    const juce::ScopedLock sl(lock);
+    entries.clear();
+    memoryUsed = 0;
+}
+
+int MidiFileCache::getNumEntries() const
+{
+    const juce::ScopedLock sl(lock);
+    return static_cast<int>(entries.size());
+}
+
+void MidiFileCache::setMemoryLimit(size_t bytes)
+{
+    const juce::ScopedLock sl(lock);
+    memoryLimit = bytes;
+    evictToMemoryLimit();
+}
+
+size_t MidiFileCache::getMemoryLimit() const
+{
+    const juce::ScopedLock sl(lock);
+    return memoryLimit;
+}
+
+size_t MidiFileCache::getMemoryUsage() const
+{
+    const juce::ScopedLock sl(lock);
+    return memoryUsed;
+}
+
+juce::int64 MidiFileCache::getNumHits() const
+{
+    const juce::ScopedLock sl(lock);
+    return numHits;
+}
+
+juce::int64 MidiFileCache::getNumMisses() const
+{
+    const juce::ScopedLock sl(lock);
+    return numMisses;
+}
+
+size_t MidiFileCache::estimateSize(const CompactMidiFile& midiFile)
+{
+    return sizeof(CompactMidiFile)
+         + midiFile.getEvents().capacity() * sizeof(CompactMidiEvent)
+         + midiFile.getTempoChanges().capacity() * sizeof(CompactMidiFile::TempoChange)
+         + midiFile.getTimeSignatures().capacity() * sizeof(CompactMidiFile::TimeSignature)
+         + midiFile.getOtherEvents().capacity() * sizeof(CompactMidiFile::OtherEvent)
+         + midiFile.getOtherEventDataSize();
+}
+
+void MidiFileCache::evictToMemoryLimit()
+{
+    // The most recent entry always stays, however large
+    while (memoryUsed > memoryLimit && entries.size() > 1)
+    {
+        auto oldest = entries.begin();
+
+        for (auto it = entries.begin(); it != entries.end(); ++it)
+        {
+            if (it->second.lastUsed < oldest->second.lastUsed)
+                oldest = it;
+        }
+
+        memoryUsed -= oldest->second.bytes;
+        entries.erase(oldest);
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <unordered_map>
+#include "CompactMidiFile.h"
+
+/**
+ * Shared cache of parsed MIDI files for the timeline and playback.
+ *
+ * A drop reads the groove for its duration, again when the clip is added to
+ * the player, and again on every repaint of the clip's dots. All of these ask
+ * this cache instead, which parses each file once into a CompactMidiFile and
+ * hands out shared read-only handles. Entries are keyed by path and checked
+ * against the file's size and modification time, so an edited file is read
+ * again. The least recently used files are dropped once the parsed events
+ * take more than the memory limit; handles that are still held stay valid.
+ *
+ * prefetch() parses files on a background thread, for example the groove
+ * selected in the browser, so the drop that follows is served from memory.
+ */
+class MidiFileCache
+{
+public:
+    using Handle = std::shared_ptr<const CompactMidiFile>;
+
+    MidiFileCache();
+    ~MidiFileCache();
+
+    // The parsed file, read on a miss; nullptr if it can't be read
+    Handle get(const juce::File& file);
+
+    // Queues files to be parsed in the background; files that are cached already are skipped
+    void prefetch(const juce::Array<juce::File>& files);
+
+    // Forgets a path so the next request reads it again
+    void invalidate(const juce::File& file);
+
+    void clear();
+    int getNumEntries() const;
+
+    void setMemoryLimit(size_t bytes);
+    size_t getMemoryLimit() const;
+    size_t getMemoryUsage() const;
+
+    // Requests from get() only; prefetches are not counted
+    juce::int64 getNumHits() const;
+    juce::int64 getNumMisses() const;
+
+private:
+    class PrefetchThread;
+
+    struct CacheEntry
+    {
+        juce::int64 size = 0;
+        juce::int64 modificationTime = 0;
+        Handle midiFile;
+        juce::uint32 lastUsed = 0;
+        size_t bytes = 0;
+    };
+
+    Handle fetch(const juce::File& file, bool countRequest);
+    static size_t estimateSize(const CompactMidiFile& midiFile);
+    void evictToMemoryLimit();
+
+    std::unordered_map<juce::String, CacheEntry> entries;
+    juce::uint32 useCounter = 0;
+
+    size_t memoryLimit = 32 * 1024 * 1024;
+    size_t memoryUsed = 0;
+
+    juce::int64 numHits = 0;
+    juce::int64 numMisses = 0;
+
+    juce::CriticalSection lock;
+
+    std::unique_ptr<PrefetchThread> prefetchThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiFileCache)
+};
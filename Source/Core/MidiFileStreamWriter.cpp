@@ -0,0 +1,149 @@
+#include "MidiFileStreamWriter.h"
+
+MidiFileStreamWriter::MidiFileStreamWriter(juce::OutputStream& out, int ticksPerQuarterNote)
+    : output(out)
+{
+    headerPosition = output.getPosition();
+
+    // The track count is filled in by finish()
+    ok = output.write("MThd", 4)
+      && output.writeIntBigEndian(6)
+      && output.writeShortBigEndian(1)
+      && output.writeShortBigEndian(0)
+      && output.writeShortBigEndian(static_cast<short>(ticksPerQuarterNote));
+}
+
+void MidiFileStreamWriter::beginTrack()
+{
+    jassert(trackLengthPosition < 0);   // endTrack() the previous one first
+
+    ok = output.write("MTrk", 4) && ok;
+    trackLengthPosition = output.getPosition();
+    ok = output.writeIntBigEndian(0) && ok;
+
+    lastTick = 0;
+    lastStatus = 0;
+}
+
+void MidiFileStreamWriter::addEvent(const juce::MidiMessage& message, juce::int64 tick)
+{
+    jassert(trackLengthPosition >= 0);
+
+    const auto* data = message.getRawData();
+    const int size = message.getRawDataSize();
+
+    if (size <= 0 || message.isEndOfTrackMetaEvent())
+        return;
+
+    writeDelta(tick);
+
+    const juce::uint8 status = data[0];
+
+    if (status == 0xf0 || status == 0xf7)
+    {
+        // Sysex is stored as its status byte, then the length of the rest
+        ok = output.writeByte(static_cast<char>(status)) && ok;
+        writeVariableLength(static_cast<juce::uint32>(size - 1));
+        ok = output.write(data + 1, static_cast<size_t>(size - 1)) && ok;
+    }
+    else if (status < 0xf0 && status == lastStatus && size > 1)
+    {
+        ok = output.write(data + 1, static_cast<size_t>(size - 1)) && ok;
+    }
+    else
+    {
+        ok = output.write(data, static_cast<size_t>(size)) && ok;
+    }
+
+    lastStatus = status;
+    ++numEvents;
+}
+
+void MidiFileStreamWriter::addEvent(juce::uint8 status, juce::uint8 data1, juce::uint8 data2, juce::int64 tick)
+{
+    jassert(trackLengthPosition >= 0 && status >= 0x80 && status < 0xf0);
+
+    writeDelta(tick);
+
+    if (status != lastStatus)
+        ok = output.writeByte(static_cast<char>(status)) && ok;
+
+    ok = output.writeByte(static_cast<char>(data1 & 0x7f)) && ok;
+
+    // Program change and channel pressure have one data byte
+    if ((status & 0xe0) != 0xc0)
+        ok = output.writeByte(static_cast<char>(data2 & 0x7f)) && ok;
+
+    lastStatus = status;
+    ++numEvents;
+}
+
+void MidiFileStreamWriter::endTrack(juce::int64 tick)
+{
+    jassert(trackLengthPosition >= 0);
+
+    writeDelta(juce::jmax(tick, lastTick));
+
+    const char endOfTrack[] = { static_cast<char>(0xff), 0x2f, 0x00 };
+    ok = output.write(endOfTrack, sizeof(endOfTrack)) && ok;
+
+    const auto length = output.getPosition() - trackLengthPosition - 4;
+    ok = patchBigEndian(trackLengthPosition, static_cast<juce::uint32>(length), 4) && ok;
+
+    trackLengthPosition = -1;
+    ++numTracks;
+}
+
+bool MidiFileStreamWriter::finish()
+{
+    if (trackLengthPosition >= 0)
+        endTrack();
+
+    ok = patchBigEndian(headerPosition + 10, static_cast<juce::uint32>(numTracks), 2) && ok;
+    output.flush();
+    return ok;
+}
+
+void MidiFileStreamWriter::writeDelta(juce::int64 tick)
+{
+    jassert(tick >= lastTick);   // Events must come in tick order
+
+    // The format caps deltas at 28 bits
+    const juce::int64 delta = juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(0x0fffffff), tick - lastTick);
+    lastTick += delta;
+    writeVariableLength(static_cast<juce::uint32>(delta));
+}
+
+void MidiFileStreamWriter::writeVariableLength(juce::uint32 value)
+{
+    char bytes[4];
+    int numBytes = 0;
+
+    // Seven bits per byte, most significant first, high bit set on all but the last
+    do
+    {
+        bytes[numBytes++] = static_cast<char>(value & 0x7f);
+        value >>= 7;
+    }
+    while (value > 0 && numBytes < 4);
+
+    for (int i = numBytes - 1; i >= 0; --i)
+        ok = output.writeByte(static_cast<char>(bytes[i] | (i > 0 ? 0x80 : 0))) && ok;
+}
+
+bool MidiFileStreamWriter::patchBigEndian(juce::int64 position, juce::uint32 value, int numBytes)
+{
+    const auto end = output.getPosition();
+
+    if (!output.setPosition(position))
+    {
+        DBG("MidiFileStreamWriter: Output stream can't seek back");
+        return false;
+    }
+
+    bool written = true;
+    for (int i = numBytes - 1; i >= 0; --i)
+        written = output.writeByte(static_cast<char>((value >> (i * 8)) & 0xff)) && written;
+
+    return output.setPosition(end) && written;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * Writes a format 1 Standard MIDI File event by event.
+ *
+ * Events are encoded as they arrive, as a delta time and the message bytes
+ * with running status, straight into the output stream, so memory use is
+ * that of the stream's buffer however long the song is. The caller supplies
+ * events in tick order, one track after the other. Track chunk lengths and
+ * the track count are filled in afterwards, so the stream must be able to
+ * seek back, as a FileOutputStream or MemoryOutputStream can.
+ */
+class MidiFileStreamWriter
+{
+public:
+    MidiFileStreamWriter(juce::OutputStream& output, int ticksPerQuarterNote);
+
+    void beginTrack();
+
+    // Ticks must not decrease within a track; an end-of-track event is ignored, endTrack() writes it
+    void addEvent(const juce::MidiMessage& message, juce::int64 tick);
+    void addEvent(juce::uint8 status, juce::uint8 data1, juce::uint8 data2, juce::int64 tick);
+
+    // Writes end-of-track at this tick, or at the last event if that is later
+    void endTrack(juce::int64 tick = 0);
+
+    // Fills in the track count; false if anything could not be written
+    bool finish();
+
+    int getNumTracks() const noexcept { return numTracks; }
+    juce::int64 getNumEvents() const noexcept { return numEvents; }
+
+private:
+    void writeDelta(juce::int64 tick);
+    void writeVariableLength(juce::uint32 value);
+    bool patchBigEndian(juce::int64 position, juce::uint32 value, int numBytes);
+
+    juce::OutputStream& output;
+    juce::int64 headerPosition = 0;
+    juce::int64 trackLengthPosition = -1;     // -1 when no track is open
+
+    juce::int64 lastTick = 0;
+    juce::uint8 lastStatus = 0;
+    int numTracks = 0;
+    juce::int64 numEvents = 0;
+    bool ok = true;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiFileStreamWriter)
+};
@@ -1,8 +1,8 @@
 #include "MidiProcessor.h"
 #include "DrumLibraryManager.h"
 
-MidiProcessor::MidiProcessor(DrumLibraryManager& drumLibManager)
-    : drumLibraryManager(drumLibManager)
+MidiProcessor::MidiProcessor(DrumLibraryManager& drumLibManager, MidiFileCache& fileCache)
+    : drumLibraryManager(drumLibManager), midiFileCache(fileCache)
 {
     sampleRate = 44100.0;
     samplesPerBlock = 512;
@@ -200,20 +200,16 @@ void MidiProcessor::clearClip(const juce::String& clipId)
 
 bool MidiProcessor::loadMidiFileWithPrecision(const juce::File& file, MidiClipPlayback& clip)
 {
-    juce::FileInputStream stream(file);
-    if (!stream.openedOk())
-    {
-        DBG("Failed to open MIDI file: " + file.getFullPathName());
-        return false;
-    }
-
-    juce::MidiFile midiFile;
-    if (!midiFile.readFrom(stream))
+    // Events come out of the reader merged across tracks and in tick order
+    const auto handle = midiFileCache.get(file);
+    if (handle == nullptr)
     {
         DBG("Failed to read MIDI file: " + file.getFullPathName());
         return false;
     }
 
+    const auto& midiFile = *handle;
+
     clip.sequence.clear();
 
     // Get precise tempo information
@@ -224,69 +220,28 @@ bool MidiProcessor::loadMidiFileWithPrecision(const juce::File& file, MidiClipPl
         DBG("Using default MIDI resolution: 480 PPQN");
     }
     
+    // The last tempo change sets the clip's tempo
     clip.originalBPM = 120.0;
-    double currentTempo = 120.0;
-    
-    // Convert MIDI file to sequence with precise timing
-    int numTracks = midiFile.getNumTracks();
-    
-    // First pass: collect all events with timing
-    juce::Array<juce::MidiMessageSequence::MidiEventHolder*> allEvents;
-    
-    for (int t = 0; t < numTracks; ++t)
+    if (!midiFile.getTempoChanges().empty())
     {
-        const juce::MidiMessageSequence* track = midiFile.getTrack(t);
-        if (track)
-        {
-            for (int i = 0; i < track->getNumEvents(); ++i)
-            {
-                juce::MidiMessageSequence::MidiEventHolder* event = track->getEventPointer(i);
-                if (event)
-                {
-                    allEvents.add(event);
-                    
-                    // Check for tempo changes
-                    if (event->message.isTempoMetaEvent())
-                    {
-                        currentTempo = 60.0 / event->message.getTempoSecondsPerQuarterNote();
-                        clip.originalBPM = currentTempo;
-                        DBG("Found tempo: " + juce::String(currentTempo, 2) + " BPM");
-                    }
-                }
-            }
-        }
+        clip.originalBPM = 60000000.0 / midiFile.getTempoChanges().back().microsecondsPerQuarterNote;
+        DBG("Found tempo: " + juce::String(clip.originalBPM, 2) + " BPM");
     }
 
-    // Sort events by timestamp
-    std::sort(allEvents.begin(), allEvents.end(),
-              [](const juce::MidiMessageSequence::MidiEventHolder* a,
-                 const juce::MidiMessageSequence::MidiEventHolder* b) {
-                  return a->message.getTimeStamp() < b->message.getTimeStamp();
-              });
-
     // Convert ticks to seconds with precise timing
-    for (auto* eventHolder : allEvents)
+    for (const auto& event : midiFile.getEvents())
     {
-        if (eventHolder->message.isNoteOn() || eventHolder->message.isNoteOff() ||
-            eventHolder->message.isController() || eventHolder->message.isProgramChange())
+        const int type = event.status & 0xf0;
+
+        if (type == 0x80 || type == 0x90 || type == 0xb0)
         {
-            double timeInSeconds = (eventHolder->message.getTimeStamp() / ticksPerQuarterNote) * (60.0 / clip.originalBPM);
-            
-            juce::MidiMessage timedEvent = eventHolder->message;
-            timedEvent.setTimeStamp(timeInSeconds);
-            
-            if (timedEvent.isNoteOn() && timedEvent.getVelocity() > 0)
-            {
-                clip.sequence.addEvent(timedEvent);
-            }
-            else if (timedEvent.isNoteOff() || (timedEvent.isNoteOn() && timedEvent.getVelocity() == 0))
-            {
-                clip.sequence.addEvent(timedEvent);
-            }
-            else if (timedEvent.isController() || timedEvent.isProgramChange())
-            {
-                clip.sequence.addEvent(timedEvent);
-            }
+            double timeInSeconds = (event.tick / ticksPerQuarterNote) * (60.0 / clip.originalBPM);
+            clip.sequence.addEvent(juce::MidiMessage(event.status, event.data1, event.data2, timeInSeconds));
+        }
+        else if (type == 0xc0)
+        {
+            double timeInSeconds = (event.tick / ticksPerQuarterNote) * (60.0 / clip.originalBPM);
+            clip.sequence.addEvent(juce::MidiMessage(event.status, event.data1, timeInSeconds));
         }
     }
 
@@ -2,6 +2,7 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 #include "DrumLibraryManager.h"
+#include "MidiFileCache.h"
 
 struct MidiClipPlayback
 {
@@ -22,7 +23,7 @@ struct MidiClipPlayback
 class MidiProcessor
 {
 public:
-    MidiProcessor(DrumLibraryManager& drumLibManager);
+    MidiProcessor(DrumLibraryManager& drumLibManager, MidiFileCache& fileCache);
     ~MidiProcessor();
 
     void prepareToPlay(double sampleRate, int samplesPerBlock);
@@ -56,6 +57,7 @@ public:
 
 private:
     DrumLibraryManager& drumLibraryManager;
+    MidiFileCache& midiFileCache;
     double sampleRate = 44100.0;
     int samplesPerBlock = 512;
     double currentBPM = 120.0;
@@ -0,0 +1,97 @@
+#include "RhythmFeatures.h"
+
+// The grid is always 4/4, whatever the file's meter, so masks and fingerprints of
+// different files line up bar for bar
+RhythmFeatureBuilder::RhythmFeatureBuilder(double ticksPerQuarterNote)
+    : ticksPerQuarter(ticksPerQuarterNote > 0.0 ? ticksPerQuarterNote : 480.0),
+      ticksPerBar(ticksPerQuarter * 4.0)
+{
+}
+
+void RhythmFeatureBuilder::addOnset(double tick, int velocity)
+{
+    if (tick < 0.0)
+        return;
+
+    // Grid position
+    int bar = static_cast<int>(tick / ticksPerBar);
+    const double stepLength = ticksPerBar / RhythmFeatures::stepsPerBar;
+    int step = juce::roundToInt((tick - bar * ticksPerBar) / stepLength);
+
+    // A hit played just ahead of a downbeat belongs to that downbeat, not to the end of the bar before
+    if (step >= RhythmFeatures::stepsPerBar)
+    {
+        step = 0;
+        ++bar;
+    }
+
+    if (bar < RhythmFeatures::maxBars)
+        features.onsetMask[bar] |= (1u << step);
+
+    lastOnsetTick = juce::jmax(lastOnsetTick, tick);
+
+    // Running velocity statistics
+    ++hits;
+    const double delta = velocity - velocityMean;
+    velocityMean += delta / hits;
+    velocitySumSquares += delta * (velocity - velocityMean);
+
+    // Swing is measured on beats split into two 8ths only. An offbeat lands between the straight
+    // 0.5 and a little past the triplet 2/3; anything else on the beat means it has 16ths.
+    const double beatTime = tick / ticksPerQuarter;
+    if (beatTime >= maxSwingBeats)
+        return;
+
+    const auto beat = static_cast<size_t>(beatTime);
+    const double beatPosition = beatTime - static_cast<double>(beat);
+
+    if (beat >= beats.size())
+        beats.resize(juce::jmin(juce::jmax(beat + 1, beats.size() * 2), static_cast<size_t>(maxSwingBeats)));
+
+    auto& beatOnsets = beats[beat];
+
+    if (beatPosition > 0.42 && beatPosition < 0.72)
+    {
+        if (beatOnsets.offbeat < 0.0f)
+            beatOnsets.offbeat = static_cast<float>(beatPosition);
+        else if (std::abs(beatOnsets.offbeat - beatPosition) > 1.0 / 12.0)
+            beatOnsets.hasSixteenths = true;
+    }
+    else if (beatPosition > 0.15 && beatPosition < 0.9)
+    {
+        beatOnsets.hasSixteenths = true;
+    }
+}
+
+RhythmFeatures RhythmFeatureBuilder::build() const
+{
+    RhythmFeatures result = features;
+
+    if (hits == 0)
+        return result;
+
+    const int bars = juce::jmax(1, static_cast<int>(lastOnsetTick / ticksPerBar) + 1);
+
+    result.barCount = static_cast<juce::uint16>(juce::jmin(bars, 0xffff));
+    result.hitCount = static_cast<juce::uint16>(juce::jmin(hits, 0xffff));
+    result.hitDensity = static_cast<float>(hits) / static_cast<float>(bars);
+    result.velocityMean = static_cast<float>(velocityMean);
+    result.velocityVariance = static_cast<float>(velocitySumSquares / hits);
+
+    // Long/short ratio of each 8th pair that is actually played
+    double swingSum = 0.0;
+    int swingCount = 0;
+
+    for (const auto& beatOnsets : beats)
+    {
+        if (beatOnsets.offbeat >= 0.0f && !beatOnsets.hasSixteenths)
+        {
+            swingSum += beatOnsets.offbeat / (1.0 - beatOnsets.offbeat);
+            ++swingCount;
+        }
+    }
+
+    result.swingRatio = swingCount > 0 ? static_cast<float>(swingSum / swingCount) : 1.0f;
+
+    return result;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <bit>
+#include <vector>
+
+/**
+ * Compact rhythm description of a drum part (or a whole groove), computed while the
+ * dissector walks the events. Fixed size and trivially copyable so it can be stored
+ * in the library index as-is.
+ */
+struct RhythmFeatures
+{
+    static constexpr int maxBars = 16;
+    static constexpr int stepsPerBar = 32;     // 32nd-note grid in 4/4
+
+    juce::uint32 onsetMask[maxBars] = {};      // Bit n set = onset on step n of that bar
+    juce::uint16 barCount = 0;
+    juce::uint16 hitCount = 0;
+    float hitDensity = 0.0f;                   // Hits per bar
+    float velocityMean = 0.0f;
+    float velocityVariance = 0.0f;
+    float swingRatio = 1.0f;                   // Long/short ratio of 8th pairs, 1.0 = straight
+
+    // Onsets of all bars folded into one bar
+    juce::uint32 getCombinedMask() const noexcept
+    {
+        juce::uint32 mask = 0;
+        for (int bar = 0; bar < juce::jmin(static_cast<int>(barCount), maxBars); ++bar)
+            mask |= onsetMask[bar];
+        return mask;
+    }
+
+    // One bar of the 32nd grid folded onto 16ths (bit n = 16th n)
+    static juce::uint32 getSixteenthMask(juce::uint32 barMask) noexcept
+    {
+        juce::uint32 mask = 0;
+        for (int step = 0; step < stepsPerBar / 2; ++step)
+            if ((barMask >> (step * 2)) & 3u)
+                mask |= 1u << step;
+        return mask;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<RhythmFeatures>, "RhythmFeatures must stay POD");
+
+/**
+ * Fixed-width onset fingerprint of a whole groove for similarity search: kick,
+ * snare and hi-hat lanes of four bars of 16ths, one 64-bit word per lane.
+ * Shorter grooves repeat to fill the four bars, so a one-bar loop matches its
+ * four-bar version.
+ */
+struct GrooveFingerprint
+{
+    enum Lane { kickLane = 0, snareLane, hiHatLane, numLanes };
+    static constexpr int barsPerLane = 4;
+
+    juce::uint64 lanes[4] = {};                // Last word is padding, keeps rows at 32 bytes
+
+    bool isEmpty() const noexcept
+    {
+        return (lanes[kickLane] | lanes[snareLane] | lanes[hiHatLane]) == 0;
+    }
+
+    // Number of 16ths where the two grooves differ, over all lanes
+    static int distance(const GrooveFingerprint& a, const GrooveFingerprint& b) noexcept
+    {
+        return std::popcount(a.lanes[0] ^ b.lanes[0]) + std::popcount(a.lanes[1] ^ b.lanes[1])
+             + std::popcount(a.lanes[2] ^ b.lanes[2]) + std::popcount(a.lanes[3] ^ b.lanes[3]);
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<GrooveFingerprint> && sizeof(GrooveFingerprint) == 32,
+              "GrooveFingerprint must stay a 32-byte POD");
+
+/**
+ * Accumulates RhythmFeatures from note-on events in a single pass.
+ */
+class RhythmFeatureBuilder
+{
+public:
+    explicit RhythmFeatureBuilder(double ticksPerQuarterNote);
+
+    void addOnset(double tick, int velocity);
+    RhythmFeatures build() const;
+
+private:
+    double ticksPerQuarter;
+    double ticksPerBar;
+    double lastOnsetTick = 0.0;
+
+    RhythmFeatures features;
+    int hits = 0;
+    double velocityMean = 0.0;
+    double velocitySumSquares = 0.0;   // Welford M2
+
+    struct BeatOnsets
+    {
+        float offbeat = -1.0f;         // Position of the 8th offbeat within the beat, -1 if none
+        bool hasSixteenths = false;
+    };
+
+    // Indexed by beat, grown as onsets arrive; swing is measured over the first maxSwingBeats only
+    static constexpr int maxSwingBeats = 1024;
+    std::vector<BeatOnsets> beats;
+};
@@ -0,0 +1,109 @@
+#include "SourceLibraryDetector.h"
+#include "CompactMidiFile.h"
+#include "MidiDissector.h"
+#include <cmath>
+
+SourceLibraryDetector::SourceLibraryDetector(const DrumLibraryManager& libraryManager)
+{
+    // General MIDI first, so libraries with the same note set never beat it
+    for (int library = static_cast<int>(DrumLibrary::GeneralMIDI); library <= static_cast<int>(DrumLibrary::Damage2); ++library)
+    {
+        Signature signature;
+        signature.library = static_cast<DrumLibrary>(library);
+
+        const auto partTable = MidiDissector::buildSourcePartTable(signature.library, libraryManager);
+        float count = 0.0f;
+
+        for (size_t note = 0; note < partTable.size(); ++note)
+        {
+            signature.weights[note] = partTable[note] != DrumPartType::Other ? 1.0f : 0.0f;
+            count += signature.weights[note];
+        }
+
+        if (count == 0.0f)
+            continue;
+
+        const float scale = 1.0f / std::sqrt(count);
+        for (auto& weight : signature.weights)
+            weight *= scale;
+
+        signatures.push_back(signature);
+    }
+}
+
+SourceLibraryDetector::Result SourceLibraryDetector::classify(const NoteHistogram& histogram) const noexcept
+{
+    Result result;
+
+    float squaredLength = 0.0f;
+    for (const float count : histogram)
+        squaredLength += count * count;
+
+    if (squaredLength <= 0.0f)
+        return result;
+
+    const float inverseLength = 1.0f / std::sqrt(squaredLength);
+
+    for (const auto& signature : signatures)
+    {
+        float dot = 0.0f;
+        for (size_t note = 0; note < histogram.size(); ++note)
+            dot += histogram[note] * signature.weights[note];
+
+        const float score = dot * inverseLength;
+
+        // Strictly better only: earlier (more common) libraries win ties
+        if (score > result.score + 1.0e-4f)
+        {
+            result.library = signature.library;
+            result.score = score;
+        }
+    }
+
+    return result;
+}
+
+void SourceLibraryDetector::addNotes(const juce::MidiFile& midiFile, NoteHistogram& histogram)
+{
+    for (int track = 0; track < midiFile.getNumTracks(); ++track)
+    {
+        for (const auto* event : *midiFile.getTrack(track))
+        {
+            if (event->message.isNoteOn())
+                histogram[static_cast<size_t>(event->message.getNoteNumber() & 0x7f)] += 1.0f;
+        }
+    }
+}
+
+void SourceLibraryDetector::addNotes(const CompactMidiFile& midiFile, NoteHistogram& histogram)
+{
+    for (const auto& event : midiFile.getEvents())
+    {
+        if (event.isNoteOn())
+            histogram[event.data1] += 1.0f;
+    }
+}
+
+SourceLibraryDetector::Result SourceLibraryDetector::classifyFolder(const juce::File& folder, int maxFiles,
+                                                                    const std::function<bool()>& shouldExit) const
+{
+    NoteHistogram histogram {};
+    CompactMidiFile midiFile;
+    int numFiles = 0;
+
+    for (const auto& entry : juce::RangedDirectoryIterator(folder, true, "*.mid;*.midi", juce::File::findFiles))
+    {
+        if (numFiles >= maxFiles || (shouldExit && shouldExit()))
+            break;
+
+        if (midiFile.load(entry.getFile()))
+        {
+            addNotes(midiFile, histogram);
+            ++numFiles;
+        }
+    }
+
+    auto result = classify(histogram);
+    result.numFiles = numFiles;
+    return result;
+}
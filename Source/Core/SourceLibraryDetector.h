@@ -0,0 +1,55 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <functional>
+#include <vector>
+#include "DrumLibraryManager.h"
+
+class CompactMidiFile;
+
+/**
+ * Guesses which drum library a groove was written for from the notes it plays.
+ *
+ * Every candidate library has a 128-bin signature vector: the notes its part
+ * table assigns to a drum part. A note histogram is scored against each
+ * signature by cosine similarity, so the library whose note set covers the hits
+ * most tightly wins, and General MIDI wins ties with libraries that use the
+ * same notes. Signatures are built once; scoring a histogram is a few thousand
+ * multiply-adds, cheap enough to run on every file during indexing.
+ */
+class SourceLibraryDetector
+{
+public:
+    using NoteHistogram = std::array<float, 128>;
+
+    struct Result
+    {
+        DrumLibrary library = DrumLibrary::Unknown;   // Unknown if there were no notes
+        float score = 0.0f;                           // Cosine similarity, 0..1
+        int numFiles = 0;                             // Files the histogram came from, for folders
+    };
+
+    explicit SourceLibraryDetector(const DrumLibraryManager& libraryManager);
+
+    Result classify(const NoteHistogram& histogram) const noexcept;
+
+    // Adds the note-ons of every track
+    static void addNotes(const juce::MidiFile& midiFile, NoteHistogram& histogram);
+    static void addNotes(const CompactMidiFile& midiFile, NoteHistogram& histogram);
+
+    // Reads up to maxFiles MIDI files below a folder into one histogram and classifies it
+    Result classifyFolder(const juce::File& folder, int maxFiles,
+                          const std::function<bool()>& shouldExit = nullptr) const;
+
+private:
+    struct Signature
+    {
+        DrumLibrary library;
+        NoteHistogram weights;     // Unit length
+    };
+
+    std::vector<Signature> signatures;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SourceLibraryDetector)
+};
@@ -2,6 +2,8 @@
 #include "../LookAndFeel/ColourPalette.h"
 #include "../LookAndFeel/DrumGrooveLookAndFeel.h"
 #include "../../PluginProcessor.h"
+#include "../../Core/GrooveLibraryIndex.h"
+#include "../../Core/SourceLibraryDetector.h"
 
 AddFolderDialog::AddFolderDialog(DrumGrooveProcessor& p)
     : DialogWindow("Add MIDI Folder to Library", ColourPalette::panelBackground, true),
@@ -26,6 +28,12 @@ AddFolderDialog::AddFolderDialog(DrumGrooveProcessor& p)
 
 AddFolderDialog::~AddFolderDialog()
 {
+    if (detectionCancelled != nullptr)
+        detectionCancelled->store(true);
+
+    // The sampling job stops at its next file once cancelled
+    detectionPool.removeAllJobs(true, 10000);
+
     stopTimer();
 }
 
@@ -70,6 +78,7 @@ void AddFolderDialog::buttonClicked(juce::Button* button)
                     }
 
                     updateAddButtonState();
+                    suggestSourceLibrary();
                 }
             }
         );
@@ -91,6 +100,7 @@ void AddFolderDialog::buttonClicked(juce::Button* button)
         {
             processingCancelled = true;
             stopTimer();
+            processor.drumLibraryManager.getLibraryIndex().cancelScan();
             setProcessingState(false);
             comp->statusLabel.setText("Operation cancelled", juce::dontSendNotification);
         }
@@ -108,7 +118,7 @@ void AddFolderDialog::comboBoxChanged(juce::ComboBox* comboBox)
 
 void AddFolderDialog::timerCallback()
 {
-    processNextChunk();
+    updateIndexingProgress();
 }
 
 void AddFolderDialog::startProcessing()
@@ -117,32 +127,19 @@ void AddFolderDialog::startProcessing()
 
     isProcessing = true;
     processingCancelled = false;
-    currentChunkIndex = 0;
     comp->progress = 0.0;
 
     setProcessingState(true);
     comp->statusLabel.setText("Scanning for MIDI files...", juce::dontSendNotification);
 
-    midiFiles.clear();
-    selectedFolder.findChildFiles(midiFiles, juce::File::findFiles, true, "*.mid;*.midi;*.MID;*.MIDI");
-
-    if (midiFiles.isEmpty())
-    {
-        setProcessingState(false);
-        juce::AlertWindow::showMessageBoxAsync(
-            juce::AlertWindow::WarningIcon,
-            "No MIDI Files Found",
-            "The selected folder doesn't contain any MIDI files.");
-        return;
-    }
-
-    comp->statusLabel.setText("Found " + juce::String(midiFiles.size()) + " MIDI files. Processing...",
-                              juce::dontSendNotification);
+    // Files are parsed into the library index on a background thread
+    processor.drumLibraryManager.getLibraryIndex().indexFolder(selectedFolder,
+                                                               static_cast<DrumLibrary>(selectedSourceLibrary));
 
-    startTimer(20);
+    startTimer(50);
 }
 
-void AddFolderDialog::processNextChunk()
+void AddFolderDialog::updateIndexingProgress()
 {
     if (processingCancelled)
     {
@@ -152,30 +149,54 @@ void AddFolderDialog::processNextChunk()
     }
 
     auto* comp = static_cast<AddFolderComponent*>(getContentComponent());
+    auto& index = processor.drumLibraryManager.getLibraryIndex();
 
-    int startIdx = currentChunkIndex * CHUNK_SIZE;
-    int endIdx = juce::jmin(startIdx + CHUNK_SIZE, midiFiles.size());
+    const auto scan = index.getScanProgress();
 
-    if (startIdx >= midiFiles.size())
+    if (!index.isScanning())
     {
+        // Unchanged files are taken over without parsing, so ask the published index
+        std::array<float, 128> noteUsage {};
+        if (index.getSnapshot()->addNoteUsage(selectedFolder, noteUsage) == 0)
+        {
+            stopTimer();
+            isProcessing = false;
+            setProcessingState(false);
+            juce::AlertWindow::showMessageBoxAsync(
+                juce::AlertWindow::WarningIcon,
+                "No MIDI Files Found",
+                "The selected folder doesn't contain any MIDI files.");
+            return;
+        }
+
         finishProcessing();
         return;
     }
 
-    comp->progress = static_cast<double>(startIdx) / static_cast<double>(midiFiles.size());
-    comp->progressBar.repaint();
+    if (scan.filesFound == 0)
+        return;   // Still walking the folder, or every file so far was unchanged
 
-    comp->statusLabel.setText("Processing files " + juce::String(startIdx + 1) +
-                              "-" + juce::String(endIdx) +
-                              " of " + juce::String(midiFiles.size()) + "...",
-                              juce::dontSendNotification);
+    juce::String status;
 
-    for (int i = startIdx; i < endIdx && !processingCancelled; ++i)
+    // The total keeps growing while the folder is walked, so the bar only fills once it is known
+    if (scan.enumerating)
+    {
+        comp->progress = -1.0;
+        status = "Found " + juce::String(scan.filesFound) + " files, indexed " + juce::String(scan.filesProcessed);
+    }
+    else
     {
-        // Processing simulation - actual processing would happen here
+        comp->progress = static_cast<double>(scan.filesProcessed) / scan.filesFound;
+        status = "Indexing file " + juce::String(scan.filesProcessed) + " of " + juce::String(scan.filesFound);
     }
 
-    currentChunkIndex++;
+    status << " (" << juce::roundToInt(scan.getFilesPerSecond()) << " files/s)";
+
+    if (scan.filesFailed > 0)
+        status << ", " << scan.filesFailed << (scan.filesFailed == 1 ? " error" : " errors");
+
+    comp->progressBar.repaint();
+    comp->statusLabel.setText(status, juce::dontSendNotification);
 }
 
 void AddFolderDialog::finishProcessing()
@@ -190,7 +211,21 @@ void AddFolderDialog::finishProcessing()
 
 	processor.drumLibraryManager.addRootFolder(selectedFolder, static_cast<DrumLibrary>(selectedSourceLibrary));
 
-    comp->statusLabel.setText("Library updated successfully!", juce::dontSendNotification);
+    auto& index = processor.drumLibraryManager.getLibraryIndex();
+    const auto scan = index.getScanProgress();
+
+    juce::String status;
+    status << "Indexed " << (scan.filesProcessed - scan.filesFailed) << " files in "
+           << juce::String(scan.elapsedSeconds, 1) << " s ("
+           << juce::roundToInt(scan.getFilesPerSecond()) << " files/s)";
+
+    if (scan.filesReused > 0)
+        status << ", " << scan.filesReused << " unchanged";
+
+    comp->statusLabel.setText(status, juce::dontSendNotification);
+
+    if (scan.filesFailed > 0)
+        showScanErrors(scan.filesFailed, index.getScanErrors());
 
     juce::Timer::callAfterDelay(500, [this]()
     {
@@ -201,6 +236,23 @@ void AddFolderDialog::finishProcessing()
     });
 }
 
+void AddFolderDialog::showScanErrors(int numFailed, const std::vector<GrooveLibraryIndex::ScanError>& errors)
+{
+    constexpr int maxErrorsListed = 10;
+
+    juce::String message;
+    message << numFailed << (numFailed == 1 ? " file was" : " files were") << " skipped:\n\n";
+
+    for (size_t i = 0; i < errors.size() && i < static_cast<size_t>(maxErrorsListed); ++i)
+        message << juce::File(errors[i].path).getFileName() << ": " << errors[i].reason << "\n";
+
+    if (numFailed > maxErrorsListed)
+        message << "...and " << (numFailed - maxErrorsListed) << " more";
+
+    juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::WarningIcon, "Some Files Could Not Be Indexed",
+                                           message.trimEnd());
+}
+
 void AddFolderDialog::setProcessingState(bool processing)
 {
     auto* comp = static_cast<AddFolderComponent*>(getContentComponent());
@@ -234,6 +286,72 @@ void AddFolderDialog::updateAddButtonState()
     comp->addButton.setEnabled(canAdd);
 }
 
+void AddFolderDialog::suggestSourceLibrary()
+{
+    if (detectionCancelled != nullptr)
+        detectionCancelled->store(true);
+
+    auto& libraryManager = processor.drumLibraryManager;
+
+    // Folders that are already indexed are answered from the stored note masks
+    SourceLibraryDetector::NoteHistogram histogram {};
+    const int numIndexed = libraryManager.getLibraryIndex().getSnapshot()->addNoteUsage(selectedFolder, histogram);
+
+    if (numIndexed > 0)
+    {
+        showSuggestedLibrary(libraryManager.getSourceLibraryDetector().classify(histogram).library, numIndexed);
+        return;
+    }
+
+    // Otherwise sample the folder's files off the message thread
+    constexpr int maxFilesToSample = 256;
+
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    detectionCancelled = cancelled;
+
+    juce::Component::SafePointer<AddFolderDialog> safeThis(this);
+    const auto folder = selectedFolder;
+    const auto& detector = libraryManager.getSourceLibraryDetector();
+
+    // Run on the dialog's own pool, which waits for it on destruction
+    detectionPool.addJob([safeThis, folder, cancelled, &detector]
+    {
+        const auto result = detector.classifyFolder(folder, maxFilesToSample,
+                                                    [cancelled] { return cancelled->load(); });
+
+        if (cancelled->load())
+            return;
+
+        juce::MessageManager::callAsync([safeThis, cancelled, result]
+        {
+            if (safeThis != nullptr && !cancelled->load())
+                safeThis->showSuggestedLibrary(result.library, result.numFiles);
+        });
+    });
+}
+
+void AddFolderDialog::showSuggestedLibrary(DrumLibrary library, int numFiles)
+{
+    auto* comp = static_cast<AddFolderComponent*>(getContentComponent());
+
+    if (library == DrumLibrary::Unknown || numFiles == 0)
+        return;
+
+    const auto libraryName = DrumLibraryManager::getLibraryName(library);
+
+    // Only fill in the choice if the user hasn't made one
+    if (comp->sourceLibraryCombo.getSelectedId() == 1)
+    {
+        const int index = DrumLibraryManager::getAllSourceLibraryNames().indexOf(libraryName);
+        if (index >= 0)
+            comp->sourceLibraryCombo.setSelectedId(index + 1, juce::sendNotificationSync);
+    }
+
+    comp->sourceHelpLabel.setText("Suggested: " + libraryName + " (from " + juce::String(numFiles)
+                                  + (numFiles == 1 ? " file)" : " files)"),
+                                  juce::dontSendNotification);
+}
+
 //==============================================================================
 AddFolderDialog::AddFolderComponent::AddFolderComponent(DrumGrooveProcessor& p)
     : processor(p), progressBar(progress)
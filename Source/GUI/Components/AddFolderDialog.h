@@ -1,6 +1,10 @@
 #pragma once
 #include <juce_gui_basics/juce_gui_basics.h>
+#include <atomic>
 #include <functional>
+#include <memory>
+#include "../../Core/DrumLibraryManager.h"
+#include "../../Core/GrooveLibraryIndex.h"
 class DrumGrooveProcessor;
 
 class AddFolderDialog : public juce::DialogWindow,
@@ -41,16 +45,18 @@ private:
     juce::File selectedFolder;
     int selectedSourceLibrary = 0;
     juce::String libraryName;
-    juce::Array<juce::File> midiFiles;
-    int currentChunkIndex = 0;
     bool isProcessing = false;
     bool processingCancelled = false;
-    static constexpr int CHUNK_SIZE = 10;
+    std::shared_ptr<std::atomic<bool>> detectionCancelled;
+    juce::ThreadPool detectionPool { 1 };
     void timerCallback() override;
     void startProcessing();
-    void processNextChunk();
+    void updateIndexingProgress();
     void finishProcessing();
+    void showScanErrors(int numFailed, const std::vector<GrooveLibraryIndex::ScanError>& errors);
     void setProcessingState(bool processing);
     void updateAddButtonState();
+    void suggestSourceLibrary();
+    void showSuggestedLibrary(DrumLibrary library, int numFiles);
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AddFolderDialog)
 };
\ No newline at end of file
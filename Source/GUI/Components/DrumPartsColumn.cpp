@@ -51,15 +51,10 @@ void DrumPartsColumn::drawPartItem(juce::Graphics& g, const DrumPart& part,
         g.fillAll(ColourPalette::mainBackground);
         g.setColour(ColourPalette::secondaryText);
 
-        if (isMouseOver())
+        if (rowNumber == hoverTracker.getHoveredRow())
         {
-            auto mousePos = getMouseXYRelative();
-            auto itemBounds = getRowPosition(rowNumber, true);
-            if (itemBounds.contains(mousePos))
-            {
-                g.fillAll(ColourPalette::secondaryBackground);
-                g.setColour(ColourPalette::primaryText);
-            }
+            g.fillAll(ColourPalette::secondaryBackground);
+            g.setColour(ColourPalette::primaryText);
         }
     }
 
@@ -97,7 +92,7 @@ void DrumPartsColumn::drawPartItem(juce::Graphics& g, const DrumPart& part,
 
 void DrumPartsColumn::drawNoteMapping(juce::Graphics& g, const DrumPart& part, juce::Rectangle<int> bounds)
 {
-    if (part.originalNotes.isEmpty())
+    if (part.getOriginalNotes().isEmpty())
         return;
 
     g.setFont(10.0f);
@@ -106,10 +101,10 @@ void DrumPartsColumn::drawNoteMapping(juce::Graphics& g, const DrumPart& part, j
     juce::String mappingText;
     
     // Show original notes
-    if (part.originalNotes.size() <= 3)
+    if (part.getOriginalNotes().size() <= 3)
     {
         juce::StringArray noteStrings;
-        for (auto note : part.originalNotes)
+        for (auto note : part.getOriginalNotes())
         {
             noteStrings.add(juce::String(note));
         }
@@ -117,19 +112,19 @@ void DrumPartsColumn::drawNoteMapping(juce::Graphics& g, const DrumPart& part, j
     }
     else
     {
-        mappingText += "Orig: " + juce::String(part.originalNotes[0]) + "..." + 
-                       juce::String(part.originalNotes.size()) + " notes";
+        mappingText += "Orig: " + juce::String(part.getOriginalNotes()[0]) + "..." + 
+                       juce::String(part.getOriginalNotes().size()) + " notes";
     }
 
     // Show remapped notes if different
-    if (!part.remappedNotes.isEmpty() && part.remappedNotes != part.originalNotes)
+    if (!part.getRemappedNotes().isEmpty() && part.getRemappedNotes() != part.getOriginalNotes())
     {
         mappingText += " → ";
         
-        if (part.remappedNotes.size() <= 3)
+        if (part.getRemappedNotes().size() <= 3)
         {
             juce::StringArray noteStrings;
-            for (auto note : part.remappedNotes)
+            for (auto note : part.getRemappedNotes())
             {
                 noteStrings.add(juce::String(note));
             }
@@ -137,8 +132,8 @@ void DrumPartsColumn::drawNoteMapping(juce::Graphics& g, const DrumPart& part, j
         }
         else
         {
-            mappingText += "Target: " + juce::String(part.remappedNotes[0]) + "..." + 
-                           juce::String(part.remappedNotes.size()) + " notes";
+            mappingText += "Target: " + juce::String(part.getRemappedNotes()[0]) + "..." + 
+                           juce::String(part.getRemappedNotes().size()) + " notes";
         }
         
         // Use a slightly different color when notes are remapped
@@ -151,7 +146,7 @@ void DrumPartsColumn::drawNoteMapping(juce::Graphics& g, const DrumPart& part, j
 
 void DrumPartsColumn::drawDrumPatternDots(juce::Graphics& g, const DrumPart& part, juce::Rectangle<int> bounds)
 {
-    if (part.sequence.getNumEvents() == 0)
+    if (part.getSequence().getNumEvents() == 0)
         return;
 
     const int numDots = 16; // 16th notes
@@ -169,9 +164,9 @@ void DrumPartsColumn::drawDrumPatternDots(juce::Graphics& g, const DrumPart& par
     dotLit.fill(false);
 
     // Process events to determine which dots to light up
-    for (int i = 0; i < part.sequence.getNumEvents(); ++i)
+    for (int i = 0; i < part.getSequence().getNumEvents(); ++i)
     {
-        const auto* event = part.sequence.getEventPointer(i);
+        const auto* event = part.getSequence().getEventPointer(i);
         if (event->message.isNoteOn() && event->message.getVelocity() > 0)
         {
             double eventTime = event->message.getTimeStamp();
@@ -271,16 +266,16 @@ void DrumPartsColumn::mouseDrag(const juce::MouseEvent& e)
             // Note mapping info
             g.setFont(10.0f);
             g.setColour(juce::Colours::white.withAlpha(0.8f));
-            if (!part.originalNotes.isEmpty())
+            if (!part.getOriginalNotes().isEmpty())
             {
                 juce::String noteInfo = "Notes: ";
-                if (part.remappedNotes != part.originalNotes && !part.remappedNotes.isEmpty())
+                if (part.getRemappedNotes() != part.getOriginalNotes() && !part.getRemappedNotes().isEmpty())
                 {
-                    noteInfo += juce::String(part.originalNotes[0]) + "→" + juce::String(part.remappedNotes[0]);
+                    noteInfo += juce::String(part.getOriginalNotes()[0]) + "→" + juce::String(part.getRemappedNotes()[0]);
                 }
                 else
                 {
-                    noteInfo += juce::String(part.originalNotes[0]);
+                    noteInfo += juce::String(part.getOriginalNotes()[0]);
                 }
                 g.drawText(noteInfo, 5, 20, 150, 15, juce::Justification::left);
             }
@@ -320,8 +315,8 @@ void DrumPartsColumn::setDrumParts(const juce::Array<DrumPart>& parts, const juc
     {
         const auto& part = parts[i];
         DBG("  Part " + juce::String(i) + ": " + part.displayName + 
-            " - Original notes: " + juce::String(part.originalNotes.size()) + 
-            ", Remapped notes: " + juce::String(part.remappedNotes.size()));
+            " - Original notes: " + juce::String(part.getOriginalNotes().size()) + 
+            ", Remapped notes: " + juce::String(part.getRemappedNotes().size()));
     }
 }
 
@@ -353,7 +348,7 @@ void DrumPartsColumn::playSelectedPart()
 
 void DrumPartsColumn::playPart(const DrumPart& part)
 {
-    if (part.sequence.getNumEvents() == 0)
+    if (part.getSequence().getNumEvents() == 0)
         return;
 
     processor.midiProcessor.stop();
@@ -401,9 +396,9 @@ void DrumPartsColumn::playPart(const DrumPart& part)
 void DrumPartsColumn::createTempMidiFile(const DrumPart& part, juce::File& tempFile)
 {
     DBG("=== createTempMidiFile ===");
-    DBG("Part: " + part.displayName + ", Events: " + juce::String(part.sequence.getNumEvents()));
+    DBG("Part: " + part.displayName + ", Events: " + juce::String(part.getSequence().getNumEvents()));
     
-    if (part.sequence.getNumEvents() == 0)
+    if (part.getSequence().getNumEvents() == 0)
     {
         DBG("ERROR: Empty sequence!");
         return;
@@ -414,9 +409,9 @@ void DrumPartsColumn::createTempMidiFile(const DrumPart& part, juce::File& tempF
 
     juce::MidiMessageSequence track;
     
-    for (int i = 0; i < part.sequence.getNumEvents(); ++i)
+    for (int i = 0; i < part.getSequence().getNumEvents(); ++i)
     {
-        const auto* event = part.sequence.getEventPointer(i);
+        const auto* event = part.getSequence().getEventPointer(i);
         if (event)
         {
             track.addEvent(event->message);
@@ -506,7 +501,7 @@ void DrumPartsColumn::exportPartToDesktop(const DrumPart& part)
     DBG("=== EXPORT DRUM PART TO DESKTOP WITH BPM ADJUSTMENT ===");
     DBG("Part: " + part.displayName);
     
-    if (part.sequence.getNumEvents() == 0)
+    if (part.getSequence().getNumEvents() == 0)
     {
         DBG("ERROR: Part has no MIDI events");
         juce::AlertWindow::showMessageBoxAsync(
@@ -577,9 +572,9 @@ void DrumPartsColumn::exportPartToDesktop(const DrumPart& part)
         DBG("Time stretch ratio: " + juce::String(timeStretchRatio, 4));
         
         // Apply time stretch to all events
-        for (int i = 0; i < part.sequence.getNumEvents(); ++i)
+        for (int i = 0; i < part.getSequence().getNumEvents(); ++i)
         {
-            const auto* event = part.sequence.getEventPointer(i);
+            const auto* event = part.getSequence().getEventPointer(i);
             if (!event) continue;
             
             auto message = event->message;
@@ -601,9 +596,9 @@ void DrumPartsColumn::exportPartToDesktop(const DrumPart& part)
         DBG("No BPM adjustment needed");
         
         // Copy events without time adjustment
-        for (int i = 0; i < part.sequence.getNumEvents(); ++i)
+        for (int i = 0; i < part.getSequence().getNumEvents(); ++i)
         {
-            const auto* event = part.sequence.getEventPointer(i);
+            const auto* event = part.getSequence().getEventPointer(i);
             if (!event) continue;
             
             auto message = event->message;
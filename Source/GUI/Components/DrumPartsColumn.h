@@ -2,6 +2,7 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "../../Core/MidiDissector.h"
+#include "RowHoverTracker.h"
 
 // Forward declarations
 class DrumGrooveProcessor;
@@ -49,6 +50,7 @@ private:
     juce::File originalMidiFile;
     juce::File lastTempFile;
     int selectedRow = -1;
+    RowHoverTracker hoverTracker { *this };
 
     // Visual elements
     void drawPartItem(juce::Graphics& g, const DrumPart& part, juce::Rectangle<int> bounds, bool isSelected, int rowNumber);
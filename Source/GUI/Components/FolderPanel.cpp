@@ -9,16 +9,21 @@
 // FavoritesModel implementation
 int FavoritesModel::getNumRows()
 {
-    return processor.favoritesManager.getNumFavorites();
+    // Favorite folders, then smart collections
+    return processor.favoritesManager.getNumFavorites() + processor.favoritesManager.getNumSmartCollections();
 }
 
 void FavoritesModel::paintListBoxItem(int rowNumber, juce::Graphics& g,
                                       int width, int height, bool rowIsSelected)
 {
-    if (rowNumber >= processor.favoritesManager.getNumFavorites())
+    auto& favorites = processor.favoritesManager;
+    const int collectionIndex = rowNumber - favorites.getNumFavorites();
+    
+    if (collectionIndex >= favorites.getNumSmartCollections())
         return;
     
-    juce::String text = processor.favoritesManager.getFavoriteName(rowNumber);
+    juce::String text = collectionIndex < 0 ? favorites.getFavoriteName(rowNumber)
+                                            : favorites.getSmartCollection(collectionIndex).name;
     
     if (rowIsSelected)
     {
@@ -34,6 +39,13 @@ void FavoritesModel::paintListBoxItem(int rowNumber, juce::Graphics& g,
     g.setFont(lnf.getNormalFont());
     g.drawText(text, 4, 0, width - 8, height, juce::Justification::centredLeft);
     
+    if (collectionIndex >= 0)
+    {
+        g.setColour(rowIsSelected ? ColourPalette::primaryText : ColourPalette::mutedText);
+        g.setFont(lnf.getSmallFont());
+        g.drawText("SMART", 4, 0, width - 8, height, juce::Justification::centredRight);
+    }
+    
     g.setColour(ColourPalette::separator);
     g.drawLine(0.0f, static_cast<float>(height - 1), static_cast<float>(width), static_cast<float>(height - 1));
 }
@@ -104,9 +116,7 @@ FolderPanel::FolderPanel(DrumGrooveProcessor& p)
         folderList.deselectAllRows(); // Clear library folders selection
         selectedFolder = -1; // Clear the selected folder index
         
-        auto path = processor.favoritesManager.getFavoritePath(row);
-        if (path.exists() && onFolderSelected)
-            onFolderSelected(path);
+        openFavorite(row);
     };
     
     favoritesList.setActualModel(favoritesModel.get());
@@ -125,9 +135,7 @@ FolderPanel::FolderPanel(DrumGrooveProcessor& p)
     addAndMakeVisible(favoritesViewport.get());
     
     favoritesList.onDoubleClick = [this](int row) {
-        auto path = processor.favoritesManager.getFavoritePath(row);
-        if (path.exists() && onFolderSelected)
-            onFolderSelected(path);
+        openFavorite(row);
     };
     
     favoritesList.onRightClick = [this](int row) {
@@ -135,6 +143,12 @@ FolderPanel::FolderPanel(DrumGrooveProcessor& p)
         DBG("Row: " + juce::String(row));
         DBG("Num favorites: " + juce::String(processor.favoritesManager.getNumFavorites()));
         
+        if (row >= processor.favoritesManager.getNumFavorites())
+        {
+            showCollectionMenu(row - processor.favoritesManager.getNumFavorites());
+            return;
+        }
+        
         if (row < 0 || row >= processor.favoritesManager.getNumFavorites())
         {
             DBG("ERROR: Row out of range!");
@@ -228,7 +242,13 @@ FolderPanel::FolderPanel(DrumGrooveProcessor& p)
     
     favoritesList.onDeletePressed = [this]() {
         auto selectedRow = favoritesList.getSelectedRow();
-        if (selectedRow >= 0)
+        const int collectionIndex = selectedRow - processor.favoritesManager.getNumFavorites();
+        if (collectionIndex >= 0 && collectionIndex < processor.favoritesManager.getNumSmartCollections())
+        {
+            processor.favoritesManager.removeSmartCollection(processor.favoritesManager.getSmartCollection(collectionIndex).id);
+            refreshFavoritesList();
+        }
+        else if (selectedRow >= 0)
         {
             auto id = processor.favoritesManager.getFavoriteId(selectedRow);
             processor.favoritesManager.removeFavorite(id);
@@ -243,7 +263,7 @@ FolderPanel::FolderPanel(DrumGrooveProcessor& p)
     refreshFolderList();
     refreshFavoritesList();
     
-    lastFavoritesCount = processor.favoritesManager.getNumFavorites();
+    lastFavoritesCount = favoritesModel->getNumRows();
     startTimer(100);
 }
 
@@ -373,6 +393,62 @@ void FolderPanel::removeSelectedFolders()
 }
 
 
+void FolderPanel::openFavorite(int row)
+{
+    auto& favorites = processor.favoritesManager;
+    const int collectionIndex = row - favorites.getNumFavorites();
+    
+    if (collectionIndex >= 0)
+    {
+        if (collectionIndex < favorites.getNumSmartCollections() && onCollectionSelected)
+            onCollectionSelected(favorites.getSmartCollection(collectionIndex).id);
+        return;
+    }
+    
+    auto path = favorites.getFavoritePath(row);
+    if (path.exists() && onFolderSelected)
+        onFolderSelected(path);
+}
+
+void FolderPanel::showCollectionMenu(int collectionIndex)
+{
+    if (collectionIndex < 0 || collectionIndex >= processor.favoritesManager.getNumSmartCollections())
+        return;
+    
+    const auto collection = processor.favoritesManager.getSmartCollection(collectionIndex);
+    
+    juce::PopupMenu menu;
+    menu.addItem(1, "Rename");
+    menu.addItem(2, "Remove Collection");
+    
+    auto mousePos = juce::Desktop::getInstance().getMainMouseSource().getScreenPosition();
+    
+    menu.showMenuAsync(juce::PopupMenu::Options()
+                           .withTargetScreenArea(juce::Rectangle<int>(static_cast<int>(mousePos.x),
+                                                                      static_cast<int>(mousePos.y), 1, 1)),
+        [this, collection](int result)
+        {
+            if (result == 1)
+            {
+                juce::AlertWindow w("Rename Collection", "Enter new name:", juce::AlertWindow::NoIcon);
+                w.addTextEditor("name", collection.name);
+                w.addButton("OK", 1, juce::KeyPress(juce::KeyPress::returnKey));
+                w.addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+                
+                if (w.runModalLoop() == 1 && w.getTextEditorContents("name").isNotEmpty())
+                {
+                    processor.favoritesManager.renameSmartCollection(collection.id, w.getTextEditorContents("name"));
+                    refreshFavoritesList();
+                }
+            }
+            else if (result == 2)
+            {
+                processor.favoritesManager.removeSmartCollection(collection.id);
+                refreshFavoritesList();
+            }
+        });
+}
+
 void FolderPanel::handleFolderDrop(const juce::String& dragDescription)
 {
     auto parts = juce::StringArray::fromTokens(dragDescription, "|", "");
@@ -457,7 +533,7 @@ void FolderPanel::refreshFavoritesList()
 
 void FolderPanel::timerCallback()
 {
-    int currentCount = processor.favoritesManager.getNumFavorites();
+    int currentCount = favoritesModel->getNumRows();
     if (currentCount != lastFavoritesCount)
     {
         lastFavoritesCount = currentCount;
@@ -160,6 +160,7 @@ public:
     int getSelectedFolderIndex() const { return selectedFolder; }
     
     std::function<void(const juce::File&)> onFolderSelected;
+    std::function<void(const juce::String&)> onCollectionSelected;   // Smart collection id
     void timerCallback() override;
 private:
     DrumGrooveProcessor& processor;
@@ -187,6 +188,8 @@ private:
     
     void removeSelectedFolders();
     void handleFolderDrop(const juce::String& dragDescription);
+    void openFavorite(int row);
+    void showCollectionMenu(int collectionIndex);
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FolderPanel)
 };
\ No newline at end of file
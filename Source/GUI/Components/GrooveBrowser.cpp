@@ -1,8 +1,13 @@
 #include "GrooveBrowser.h"
 #include "DrumPartsColumn.h"
+#include "GrooveFilterPanel.h"
 #include "../../PluginProcessor.h"
+#include "../../Core/GrooveLibraryIndex.h"
+#include "../../Core/GrooveSearchIndex.h"
+#include "../../Core/GrooveThumbnailCache.h"
 #include "../LookAndFeel/ColourPalette.h"
 #include "../LookAndFeel/DrumGrooveLookAndFeel.h"
+#include <numeric>
 
 //==============================================================================
 // DraggableListItemOverlay implementation
@@ -74,11 +79,14 @@ BrowserColumn::BrowserColumn(const juce::String& columnName, DrumGrooveProcessor
     setColour(juce::ListBox::backgroundColourId, ColourPalette::mainBackground);
     setMultipleSelectionEnabled(false);
     loadIcons();
+
+    rowFont = DrumGrooveLookAndFeel::getInstance().getNormalFont().withHeight(13.0f);
 }
 
 juce::Component* BrowserColumn::refreshComponentForRow(int rowNumber, bool isRowSelected, juce::Component* existingComponentToUpdate)
 {
-    // Create transparent overlay component for each row that handles CTRL+Drag
+    // Transparent overlay that handles CTRL+Drag. The ListBox keeps one per visible
+    // row and hands it back here as rows scroll, so only the row number changes.
     auto* overlay = dynamic_cast<DraggableListItemOverlay*>(existingComponentToUpdate);
     
     if (overlay == nullptr)
@@ -153,34 +161,79 @@ void BrowserColumn::loadIcons()
 
 int BrowserColumn::getNumRows()
 {
-    return items.size();
+    return getNumItems();
+}
+
+const BrowserColumn::CachedRowText& BrowserColumn::getRowText(int row, int width, int height)
+{
+    auto& cached = rowTextCache[static_cast<size_t>(row) % rowTextCache.size()];
+
+    if (cached.row == row && cached.width == width && cached.contentVersion == contentVersion)
+        return cached;
+
+    cached.row = row;
+    cached.width = width;
+    cached.contentVersion = contentVersion;
+    cached.name.clear();
+    cached.bpm.clear();
+    cached.thumbnailHash = 0;
+
+    int textWidth = width - 28;
+    int rightEdge = width - 4;
+    const auto& item = items[static_cast<size_t>(row)];
+
+    if (!item.isFolder && item.bpm > 0.0f)
+    {
+        cached.bpm.addFittedText(rowFont, juce::String(juce::roundToInt(item.bpm)),
+                                 static_cast<float>(width - 44), 0.0f, 40.0f, static_cast<float>(height),
+                                 juce::Justification::centredRight, 1);
+        textWidth -= 44;
+        rightEdge -= 44;
+    }
+
+    // Pattern thumbnail left of the BPM, when the column leaves room for the name
+    constexpr int thumbnailWidth = GrooveThumbnailCache::thumbnailWidth;
+    if (!item.isFolder && item.isIndexed && textWidth - thumbnailWidth - 6 >= 100)
+    {
+        cached.thumbnailHash = GrooveThumbnailCache::getContentHash(snapshot->getFeatures(item.pathRef));
+
+        if (cached.thumbnailHash != 0)
+        {
+            cached.thumbnailArea = { rightEdge - thumbnailWidth, (height - GrooveThumbnailCache::thumbnailHeight) / 2,
+                                     thumbnailWidth, GrooveThumbnailCache::thumbnailHeight };
+            textWidth -= thumbnailWidth + 6;
+        }
+    }
+
+    const float baseline = (static_cast<float>(height) + rowFont.getAscent() - rowFont.getDescent()) * 0.5f;
+    cached.name.addCurtailedLineOfText(rowFont, getItemName(row), 24.0f, baseline,
+                                       static_cast<float>(textWidth), true);
+
+    return cached;
 }
 
 void BrowserColumn::paintListBoxItem(int rowNumber, juce::Graphics& g,
                                      int width, int height, bool rowIsSelected)
 {
-    if (rowNumber >= items.size())
+    if (rowNumber < 0 || rowNumber >= getNumItems())
         return;
 
+    juce::Colour textColour;
+
     if (rowIsSelected)
     {
         g.fillAll(ColourPalette::primaryBlue);
-        g.setColour(ColourPalette::primaryText);
+        textColour = ColourPalette::primaryText;
     }
     else
     {
         g.fillAll(ColourPalette::mainBackground);
-        g.setColour(ColourPalette::secondaryText);
+        textColour = ColourPalette::secondaryText;
 
-        if (isMouseOver())
+        if (rowNumber == hoverTracker.getHoveredRow())
         {
-            auto mousePos = getMouseXYRelative();
-            auto itemBounds = getRowPosition(rowNumber, true);
-            if (itemBounds.contains(mousePos))
-            {
-                g.fillAll(ColourPalette::secondaryBackground);
-                g.setColour(ColourPalette::primaryText);
-            }
+            g.fillAll(ColourPalette::secondaryBackground);
+            textColour = ColourPalette::primaryText;
         }
     }
 
@@ -188,7 +241,7 @@ void BrowserColumn::paintListBoxItem(int rowNumber, juce::Graphics& g,
     int iconX = 4;
     int iconY = (height - 16) / 2;
 
-    if (itemIsFolder[rowNumber])
+    if (isItemFolder(rowNumber))
     {
         g.drawImageAt(folderIcon, iconX, iconY);
     }
@@ -197,12 +250,18 @@ void BrowserColumn::paintListBoxItem(int rowNumber, juce::Graphics& g,
         g.drawImageAt(midiIcon, iconX, iconY);
     }
 
-    // Draw text (just the filename, no BPM info)
-    auto& lnf = DrumGrooveLookAndFeel::getInstance();
-    g.setFont(lnf.getNormalFont().withHeight(13.0f));
+    // Draw text, with the file's BPM right-aligned when it is known
+    const auto& text = getRowText(rowNumber, width, height);
+
+    g.setColour(rowIsSelected ? ColourPalette::primaryText : ColourPalette::secondaryText.withAlpha(0.7f));
+    text.bpm.draw(g);
+
+    // Only ever blits from the atlas; rows repaint when the thumbnail arrives
+    if (text.thumbnailHash != 0)
+        processor.drumLibraryManager.getThumbnailCache().draw(g, text.thumbnailHash, text.thumbnailArea);
 
-    juce::String text = items[rowNumber];
-    g.drawText(text, 24, 0, width - 28, height, juce::Justification::centredLeft);
+    g.setColour(textColour);
+    text.name.draw(g);
 
     // Draw separator
     g.setColour(ColourPalette::separator);
@@ -222,44 +281,233 @@ void BrowserColumn::listBoxItemDoubleClicked(int row, const juce::MouseEvent&)
         onDoubleClick(row);
 }
 
-void BrowserColumn::setItems(const juce::StringArray& newItems, 
-                            const juce::Array<bool>& newIsFolder, 
-                            const juce::Array<juce::File>& filePaths)
+void BrowserColumn::ItemBatch::addIndexed(int snapshotRow, bool isFolder, double bpm)
+{
+    items.push_back({ static_cast<juce::int32>(snapshotRow), static_cast<float>(bpm), isFolder, true });
+}
+
+void BrowserColumn::ItemBatch::addPath(const juce::File& file, bool isFolder, double bpm)
 {
-    items = newItems;
-    itemIsFolder = newIsFolder;
-    itemFiles = filePaths;
+    items.push_back({ static_cast<juce::int32>(localPaths.size()), static_cast<float>(bpm), isFolder, false });
+    localPaths.add(file.getFullPathName());
+}
+
+void BrowserColumn::appendBatch(ItemBatch&& batch)
+{
+    // Items can only point into one snapshot - resolve the paths of any other
+    const bool keepsIndexRefs = batch.snapshot == nullptr || snapshot == nullptr || batch.snapshot == snapshot
+                                || items.empty();
+    if (keepsIndexRefs && batch.snapshot != nullptr)
+        snapshot = batch.snapshot;
+
+    const int localBase = localPaths.size();
+    localPaths.addArray(batch.localPaths);
+    items.reserve(items.size() + batch.items.size());
+
+    for (auto item : batch.items)
+    {
+        if (!item.isIndexed)
+        {
+            item.pathRef += localBase;
+        }
+        else if (!keepsIndexRefs)
+        {
+            localPaths.add(batch.snapshot->getPath(item.pathRef));
+            item.isIndexed = false;
+            item.pathRef = localPaths.size() - 1;
+        }
+
+        items.push_back(item);
+    }
+
+    ++contentVersion;
+}
+
+void BrowserColumn::setItems(ItemBatch batch)
+{
+    items.clear();
+    localPaths.clear();
+    snapshot = nullptr;
+    ++listingGeneration;
+
+    appendBatch(std::move(batch));
     updateContent();
+    repaint();
+}
+
+void BrowserColumn::addItems(ItemBatch batch)
+{
+    const juce::File selectedFile = selectedRow >= 0 ? getSelectedFile() : pendingSelection;
+    const auto numSorted = static_cast<std::ptrdiff_t>(items.size());
+
+    appendBatch(std::move(batch));
+
+    // The column is already in order, so only the new chunk is sorted before merging it in.
+    // Index rows arrive in path order, which makes both steps close to linear.
+    const ItemOrder comesFirst { *this };
+    std::stable_sort(items.begin() + numSorted, items.end(), comesFirst);
+    std::inplace_merge(items.begin(), items.begin() + numSorted, items.end(), comesFirst);
+
+    itemsReordered(selectedFile);
+}
+
+void BrowserColumn::setSortOrder(SortOrder newOrder)
+{
+    if (sortOrder == newOrder)
+        return;
+
+    sortOrder = newOrder;
+    sortItems();
+}
+
+const char* BrowserColumn::getItemPath(const Item& item, size_t& length) const noexcept
+{
+    if (item.isIndexed)
+        return snapshot->getPathUTF8(item.pathRef, length);
+
+    const auto& path = localPaths.getReference(item.pathRef);
+    length = path.getNumBytesAsUTF8();
+    return path.toRawUTF8();
+}
+
+int BrowserColumn::findItem(const juce::File& file) const
+{
+    const juce::String target = file.getFullPathName();
+    const size_t targetLength = target.getNumBytesAsUTF8();
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        size_t length = 0;
+        const char* path = getItemPath(items[i], length);
+
+        if (length == targetLength && std::memcmp(path, target.toRawUTF8(), length) == 0)
+            return static_cast<int>(i);
+    }
+
+    return -1;
+}
+
+// Folders first by name, then files in the chosen order. Files without a known
+// tempo sort after the others by BPM. Paths compare as raw UTF-8 bytes, the
+// order the index stores them in, so no strings are built while comparing.
+bool BrowserColumn::ItemOrder::operator()(const Item& a, const Item& b) const noexcept
+{
+    if (a.isFolder != b.isFolder)
+        return a.isFolder;
+
+    if (column.sortOrder == SortOrder::Bpm && !a.isFolder && a.bpm != b.bpm)
+    {
+        if (a.bpm <= 0.0f || b.bpm <= 0.0f)
+            return a.bpm > 0.0f;
+        return a.bpm < b.bpm;
+    }
+
+    size_t aLength = 0, bLength = 0;
+    const char* aPath = column.getItemPath(a, aLength);
+    const char* bPath = column.getItemPath(b, bLength);
+    const int result = std::memcmp(aPath, bPath, juce::jmin(aLength, bLength));
+    return result != 0 ? result < 0 : aLength < bLength;
+}
+
+void BrowserColumn::sortItems()
+{
+    const juce::File selectedFile = selectedRow >= 0 ? getSelectedFile() : pendingSelection;
+
+    std::stable_sort(items.begin(), items.end(), ItemOrder { *this });
+
+    itemsReordered(selectedFile);
+}
+
+void BrowserColumn::itemsReordered(const juce::File& selectedFile)
+{
+    ++contentVersion;
+
+    // Rows moved under the selection - follow the selected file without notifying
+    if (selectedFile != juce::File())
+    {
+        selectedRow = findItem(selectedFile);
+
+        juce::SparseSet<int> rows;
+        if (selectedRow >= 0)
+        {
+            rows.addRange({ selectedRow, selectedRow + 1 });
+            pendingSelection = juce::File();
+        }
+        setSelectedRows(rows, juce::dontSendNotification);
+    }
+
+    updateContent();
+    repaint();
+}
+
+void BrowserColumn::clearItemsKeepingSelection()
+{
+    const juce::File selectedFile = selectedRow >= 0 ? getSelectedFile() : pendingSelection;
+    clearItems();
+    pendingSelection = selectedFile;
 }
 
 void BrowserColumn::clearItems()
 {
+    pendingSelection = juce::File();
     items.clear();
-    itemIsFolder.clear();
-    itemFiles.clear();
+    localPaths.clear();
+    snapshot = nullptr;
+    ++contentVersion;
+    ++listingGeneration;
     selectedRow = -1;
     updateContent();
 }
 
+juce::String BrowserColumn::getItemName(int row) const
+{
+    size_t length = 0;
+    const char* path = getItemPath(items[static_cast<size_t>(row)], length);
+
+    // Last path component, straight from the UTF-8 bytes
+    size_t start = length;
+    while (start > 0 && path[start - 1] != juce::File::getSeparatorChar())
+        --start;
+
+    const auto name = juce::String::fromUTF8(path + start, static_cast<int>(length - start));
+    return GrooveBrowser::formatFileName(name, !items[static_cast<size_t>(row)].isFolder);
+}
+
+juce::File BrowserColumn::getItemFile(int row) const
+{
+    if (row < 0 || row >= getNumItems())
+        return {};
+
+    size_t length = 0;
+    const char* path = getItemPath(items[static_cast<size_t>(row)], length);
+    return juce::File(juce::String::fromUTF8(path, static_cast<int>(length)));
+}
+
+bool BrowserColumn::isItemFolder(int row) const
+{
+    return row >= 0 && row < getNumItems() && items[static_cast<size_t>(row)].isFolder;
+}
+
+double BrowserColumn::getItemBpm(int row) const
+{
+    return row >= 0 && row < getNumItems() ? items[static_cast<size_t>(row)].bpm : 0.0;
+}
+
 juce::String BrowserColumn::getSelectedItem() const
 {
-    if (selectedRow >= 0 && selectedRow < items.size())
-        return items[selectedRow];
+    if (selectedRow >= 0 && selectedRow < getNumItems())
+        return getItemName(selectedRow);
     return {};
 }
 
 bool BrowserColumn::isSelectedItemFolder() const
 {
-    if (selectedRow >= 0 && selectedRow < itemIsFolder.size())
-        return itemIsFolder[selectedRow];
-    return false;
+    return isItemFolder(selectedRow);
 }
 
 juce::File BrowserColumn::getSelectedFile() const
 {
-    if (selectedRow >= 0 && selectedRow < itemFiles.size())
-        return itemFiles[selectedRow];
-    return {};
+    return getItemFile(selectedRow);
 }
 
 juce::var BrowserColumn::getDragSourceDescription(const juce::SparseSet<int>& selectedRows)
@@ -267,23 +515,24 @@ juce::var BrowserColumn::getDragSourceDescription(const juce::SparseSet<int>& se
     if (selectedRows.size() > 0)
     {
         int row = selectedRows[0];
-        if (row >= 0 && row < items.size())
+        if (row >= 0 && row < getNumItems())
         {
-            juce::String filename = items[row];
+            juce::String filename = getItemName(row);
+            const juce::File file = getItemFile(row);
             
-            if (itemIsFolder[row])
+            if (isItemFolder(row))
             {
                 // Folder drag
-                juce::String fullPath = itemFiles[row].getFullPathName();
+                juce::String fullPath = file.getFullPathName();
                 return juce::var(filename + "|FOLDER|" + fullPath);
             }
             else
             {
                 // File drag
                 juce::String fullPath;
-                if (row < itemFiles.size() && itemFiles[row].existsAsFile())
+                if (file.existsAsFile())
                 {
-                    fullPath = itemFiles[row].getFullPathName();
+                    fullPath = file.getFullPathName();
                 }
                 else
                 {
@@ -306,21 +555,21 @@ void BrowserColumn::startExternalDrag(int rowNumber)
     DBG("=== STARTING EXTERNAL DRAG FROM ROW " + juce::String(rowNumber) + " ===");
     
     // Validate selection
-    if (rowNumber < 0 || rowNumber >= items.size())
+    if (rowNumber < 0 || rowNumber >= getNumItems())
     {
         DBG("ERROR: Invalid row number");
         isExternalDragActive = false;
         return;
     }
     
-    if (itemIsFolder[rowNumber])
+    if (isItemFolder(rowNumber))
     {
         DBG("ERROR: Cannot drag folders");
         isExternalDragActive = false;
         return;
     }
     
-    juce::File originalMidiFile = itemFiles[rowNumber];
+    juce::File originalMidiFile = getItemFile(rowNumber);
     if (!originalMidiFile.existsAsFile())
     {
         DBG("ERROR: File doesn't exist: " + originalMidiFile.getFullPathName());
@@ -357,34 +606,51 @@ void BrowserColumn::startExternalDrag(int rowNumber)
     
     DBG("Current BPM: " + juce::String(currentBPM, 2));
     
-    // Read original MIDI to check BPM
+    // The original BPM comes from the library index; the file is only read when
+    // its tempo is unknown or it has to be rewritten at a different tempo
     juce::MidiFile originalMidi;
-    juce::FileInputStream inputStream(originalMidiFile);
-    if (!inputStream.openedOk() || !originalMidi.readFrom(inputStream))
+    bool isOriginalMidiLoaded = false;
+
+    auto loadOriginalMidi = [&]()
     {
-        DBG("ERROR: Cannot read MIDI file");
-        isExternalDragActive = false;
-        return;
-    }
-    
-    // Get original BPM from tempo track
-    double originalBPM = 120.0;
-    bool foundBPM = false;
-    for (int track = 0; track < originalMidi.getNumTracks(); ++track)
+        if (isOriginalMidiLoaded)
+            return true;
+
+        juce::FileInputStream inputStream(originalMidiFile);
+        isOriginalMidiLoaded = inputStream.openedOk() && originalMidi.readFrom(inputStream);
+        return isOriginalMidiLoaded;
+    };
+
+    double originalBPM = getItemBpm(rowNumber);
+
+    if (originalBPM <= 0.0)
     {
-        auto* tempoTrack = originalMidi.getTrack(track);
-        for (int i = 0; i < tempoTrack->getNumEvents(); ++i)
+        if (!loadOriginalMidi())
         {
-            auto& event = tempoTrack->getEventPointer(i)->message;
-            if (event.isTempoMetaEvent())
+            DBG("ERROR: Cannot read MIDI file");
+            isExternalDragActive = false;
+            return;
+        }
+
+        // Get original BPM from tempo track
+        originalBPM = 120.0;
+        bool foundBPM = false;
+        for (int track = 0; track < originalMidi.getNumTracks(); ++track)
+        {
+            auto* tempoTrack = originalMidi.getTrack(track);
+            for (int i = 0; i < tempoTrack->getNumEvents(); ++i)
             {
-                originalBPM = 60000000.0 / event.getTempoSecondsPerQuarterNote() / 1000000.0;
-                foundBPM = true;
-                DBG("Found original BPM: " + juce::String(originalBPM, 2));
-                break;
+                auto& event = tempoTrack->getEventPointer(i)->message;
+                if (event.isTempoMetaEvent())
+                {
+                    originalBPM = 60000000.0 / event.getTempoSecondsPerQuarterNote() / 1000000.0;
+                    foundBPM = true;
+                    DBG("Found original BPM: " + juce::String(originalBPM, 2));
+                    break;
+                }
             }
+            if (foundBPM) break;
         }
-        if (foundBPM) break;
     }
     
     juce::File fileToDrag;
@@ -393,6 +659,13 @@ void BrowserColumn::startExternalDrag(int rowNumber)
     if (std::abs(originalBPM - currentBPM) > 0.01)
     {
         DBG("BPM adjustment needed: " + juce::String(originalBPM, 2) + " -> " + juce::String(currentBPM, 2));
+
+        if (!loadOriginalMidi())
+        {
+            DBG("ERROR: Cannot read MIDI file");
+            isExternalDragActive = false;
+            return;
+        }
         
         // Create temp file with unique name
         juce::String tempFileName = "DrumGroovePro_drag_" + 
@@ -559,6 +832,22 @@ GrooveBrowser::GrooveBrowser(DrumGrooveProcessor& p)
     targetLibraryLabel.setJustificationType(juce::Justification::centredRight);
     addAndMakeVisible(targetLibraryLabel);
 
+    // Search box - top left of the browser
+    searchBox.setFont(lnf.getNormalFont().withHeight(13.0f));
+    searchBox.setTextToShowWhenEmpty("Search library...", ColourPalette::secondaryText);
+    searchBox.setColour(juce::TextEditor::backgroundColourId, ColourPalette::inputBackground);
+    searchBox.setColour(juce::TextEditor::textColourId, ColourPalette::primaryText);
+    searchBox.setColour(juce::TextEditor::outlineColourId, ColourPalette::borderColour);
+    searchBox.onTextChange = [this]() { updateSearchResults(); };
+    searchBox.onEscapeKey = [this]() { searchBox.clear(); updateSearchResults(); };
+    addAndMakeVisible(searchBox);
+
+    filterButton.onClick = [this]() { showFilterPanel(); };
+    addAndMakeVisible(filterButton);
+    processor.drumLibraryManager.getSearchIndex().addChangeListener(this);
+    processor.drumLibraryManager.getThumbnailCache().addChangeListener(this);
+    processor.favoritesManager.addChangeListener(this);
+
     // Populate combo box with library names (in alphabetical order)
     auto libraryNames = DrumLibraryManager::getAllLibraryNames();
     for (int i = 0; i < libraryNames.size(); ++i)
@@ -631,6 +920,8 @@ GrooveBrowser::GrooveBrowser(DrumGrooveProcessor& p)
     // Add listeners AFTER attachment
     targetLibraryCombo.addListener(this);
     processor.parameters.addParameterListener("targetLibrary", this);
+    processor.parameters.addParameterListener("manualBPM", this);
+    processor.parameters.addParameterListener("syncToHost", this);
     
     DBG("GrooveBrowser initialized successfully");
     DBG("  Final ComboBox text: " + targetLibraryCombo.getText());
@@ -640,15 +931,22 @@ GrooveBrowser::GrooveBrowser(DrumGrooveProcessor& p)
     viewport.setScrollBarsShown(false, true);
     addAndMakeVisible(viewport);
 
-    startTimer(100);
+    startTimer(250);
 }
 
 
 GrooveBrowser::~GrooveBrowser()
 {
+    cancelPendingUpdate();
     stopTimer();
+    processor.favoritesManager.removeChangeListener(this);
+    processor.drumLibraryManager.getThumbnailCache().removeChangeListener(this);
+    processor.drumLibraryManager.getSearchIndex().removeChangeListener(this);
+    listingPool.removeAllJobs(true, 2000);
     targetLibraryCombo.removeListener(this);
     processor.parameters.removeParameterListener("targetLibrary", this);
+    processor.parameters.removeParameterListener("manualBPM", this);
+    processor.parameters.removeParameterListener("syncToHost", this);
 }
 
 void GrooveBrowser::paint(juce::Graphics& g)
@@ -666,6 +964,8 @@ void GrooveBrowser::resized()
     targetLibraryCombo.setBounds(rightSection.removeFromRight(200).reduced(0, 5));
     rightSection.removeFromRight(2); // REDUCED: Small gap between label and combo (was 5, now 2)
     targetLibraryLabel.setBounds(rightSection.reduced(0, 5));
+    searchBox.setBounds(topBar.removeFromLeft(260).reduced(4, 5));
+    filterButton.setBounds(topBar.removeFromLeft(70).reduced(0, 5));
 
     // Viewport fills rest
     viewport.setBounds(bounds);
@@ -712,6 +1012,11 @@ void GrooveBrowser::parameterChanged(const juce::String& parameterID, float newV
         // Handle the library change
         handleTargetLibraryChange();
     }
+    else if (parameterID == "manualBPM" || parameterID == "syncToHost")
+    {
+        // May arrive on the audio thread
+        triggerAsyncUpdate();
+    }
 }
 
 // NEW: Handle target library change
@@ -780,13 +1085,12 @@ void GrooveBrowser::redissectCurrentMidiFile()
         " with target library: " + juce::String(static_cast<int>(newTargetLibrary)) +
         " (" + DrumLibraryManager::getLibraryName(newTargetLibrary) + ")");
 
-    // CRITICAL: Always perform full re-dissection to ensure accurate real-time updates
-    // This guarantees that all drum parts are correctly categorized and remapped
-    currentDrumParts = midiDissector.dissectMidiFileWithLibraryManager(
+    // Parts are already dissected on their source notes - only the cached
+    // projection onto the new target library is fetched (no file I/O)
+    currentDrumParts = processor.dissectionCache.getRemappedDrumParts(
         currentMidiFile, 
         currentSourceLibrary, 
-        newTargetLibrary, 
-        processor.drumLibraryManager);
+        newTargetLibrary);
     
     // Update source library in parts
     for (auto& part : currentDrumParts)
@@ -831,10 +1135,12 @@ void GrooveBrowser::loadFolderContents(const juce::File& folder)
     if (!folder.exists())
         return;
 
+    cancelFolderListings(0);
     folderColumns.clear();
     removePartsColumn(); // Clear any existing parts column
     navigationPath.clear();
     currentPath = folder;
+    shownCollectionId.clear();
 
     navigateToFolder(folder, 0);
 }
@@ -857,18 +1163,7 @@ void GrooveBrowser::handleFileDoubleClick(const juce::File& file)
         processor.midiProcessor.clearAllClips();
 
         // Find source library for this file
-        DrumLibrary sourceLib = DrumLibrary::Unknown;
-        auto& library = processor.drumLibraryManager;
-
-        for (int i = 0; i < library.getNumRootFolders(); ++i)
-        {
-            auto rootFolder = library.getRootFolder(i);
-            if (file.getFullPathName().startsWith(rootFolder.getFullPathName()))
-            {
-                sourceLib = library.getRootFolderSourceLibrary(i);
-                break;
-            }
-        }
+        DrumLibrary sourceLib = processor.drumLibraryManager.getSourceLibraryFor(file);
 
         // Get the header BPM (user's desired playback speed)
         double headerBPM = 120.0;
@@ -888,6 +1183,7 @@ void GrooveBrowser::handleFileDoubleClick(const juce::File& file)
         processor.midiProcessor.addMidiClip(file, 0.0, sourceLib, 120.0, headerBPM, 0);
         processor.midiProcessor.setPlayheadPosition(0.0);
         processor.midiProcessor.play();
+        processor.usageTracker.recordUse(file, GrooveUsageTracker::Action::Audition);
 
         DBG("Playing file: " + file.getFullPathName() + " at " + juce::String(headerBPM, 2) + " BPM");
     }
@@ -924,19 +1220,11 @@ void GrooveBrowser::handleMidiFileSelection(const juce::File& midiFile)
 
     currentMidiFile = midiFile;
 
-    // Find source library for this file
-    DrumLibrary sourceLib = DrumLibrary::Unknown;
-    auto& library = processor.drumLibraryManager;
+    // A selected groove is likely to be dropped next
+    processor.midiFileCache.prefetch({ midiFile });
 
-    for (int i = 0; i < library.getNumRootFolders(); ++i)
-    {
-        auto rootFolder = library.getRootFolder(i);
-        if (midiFile.getFullPathName().startsWith(rootFolder.getFullPathName()))
-        {
-            sourceLib = library.getRootFolderSourceLibrary(i);
-            break;
-        }
-    }
+    // Find source library for this file
+    DrumLibrary sourceLib = processor.drumLibraryManager.getSourceLibraryFor(midiFile);
 
     // Store the source library for future remapping
     currentSourceLibrary = sourceLib;
@@ -945,7 +1233,7 @@ void GrooveBrowser::handleMidiFileSelection(const juce::File& midiFile)
     DrumLibrary targetLib = getCurrentTargetLibrary();
 
     // Dissect the MIDI file with BOTH source and target libraries AND library manager
-    currentDrumParts = midiDissector.dissectMidiFileWithLibraryManager(midiFile, sourceLib, targetLib, processor.drumLibraryManager);
+    currentDrumParts = processor.dissectionCache.getDrumParts(midiFile, sourceLib, targetLib);
 
     if (!currentDrumParts.isEmpty())
     {
@@ -983,6 +1271,10 @@ void GrooveBrowser::handleDrumPartDoubleClick(const DrumPart& part)
 {
     DBG("Playing drum part: " + part.displayName);
     // The DrumPartsColumn handles the actual playback
+
+    // Parts are cached with their file, so an audition counts for the file
+    if (currentMidiFile.existsAsFile())
+        processor.usageTracker.recordUse(currentMidiFile, GrooveUsageTracker::Action::Audition);
 }
 
 juce::File GrooveBrowser::getCurrentFileForRow(int columnIndex, int row)
@@ -990,9 +1282,9 @@ juce::File GrooveBrowser::getCurrentFileForRow(int columnIndex, int row)
     if (columnIndex >= 0 && columnIndex < folderColumns.size())
     {
         BrowserColumn* column = folderColumns[columnIndex];
-        if (row >= 0 && row < column->itemFiles.size() && !column->itemIsFolder[row])
+        if (row >= 0 && row < column->getNumItems() && !column->isItemFolder(row))
         {
-            return column->itemFiles[row];
+            return column->getItemFile(row);
         }
     }
     return juce::File();
@@ -1004,41 +1296,42 @@ bool GrooveBrowser::keyPressed(const juce::KeyPress& key)
     return false;
 }
 
+void GrooveBrowser::handleAsyncUpdate()
+{
+    updatePlaybackBPM();
+}
+
 void GrooveBrowser::timerCallback()
 {
-    // Update hover states
-    for (auto* column : folderColumns)
+    // Host tempo changes have no parameter behind them, so they are picked up here
+    updatePlaybackBPM();
+}
+
+void GrooveBrowser::updatePlaybackBPM()
+{
+    // Check if BPM changed during playback
+    if (!processor.midiProcessor.isPlaying())
+        return;
+
+    double currentBPM = 120.0;
+    bool syncToHost = processor.parameters.getRawParameterValue("syncToHost")->load() > 0.5f;
+
+    if (syncToHost)
     {
-        column->repaint();
+        // As seen by the last audio block
+        currentBPM = processor.getEffectiveBPM();
     }
-
-    if (partsColumn)
+    else
     {
-        partsColumn->repaint();
+        currentBPM = processor.parameters.getRawParameterValue("manualBPM")->load();
     }
-    
-    // Check if BPM changed during playback
-    if (processor.midiProcessor.isPlaying())
+
+    // If BPM changed, update track 0 (browser playback uses track 0)
+    if (std::abs(currentBPM - lastKnownBPM) > 0.01)
     {
-        double currentBPM = 120.0;
-        bool syncToHost = processor.parameters.getRawParameterValue("syncToHost")->load() > 0.5f;
-        
-        if (syncToHost)
-        {
-            currentBPM = processor.getHostBPM();
-        }
-        else
-        {
-            currentBPM = processor.parameters.getRawParameterValue("manualBPM")->load();
-        }
-        
-        // If BPM changed, update track 0 (browser playback uses track 0)
-        if (std::abs(currentBPM - lastKnownBPM) > 0.01)
-        {
-            processor.midiProcessor.updateTrackBPM(0, currentBPM);
-            lastKnownBPM = currentBPM;
-            DBG("GrooveBrowser: BPM changed to " + juce::String(currentBPM, 2) + " BPM");
-        }
+        processor.midiProcessor.updateTrackBPM(0, currentBPM);
+        lastKnownBPM = currentBPM;
+        DBG("GrooveBrowser: BPM changed to " + juce::String(currentBPM, 2) + " BPM");
     }
 }
 
@@ -1067,6 +1360,30 @@ void GrooveBrowser::addFolderColumn(const juce::String& title, bool isFileColumn
         handleColumnDoubleClick(columnIndex, row);
     };
 
+    // One sort order for all columns
+    column->setSortOrder(columnSortOrder);
+    column->onSortOrderChange = [this](BrowserColumn::SortOrder newOrder) {
+        columnSortOrder = newOrder;
+        for (auto* other : folderColumns)
+            other->setSortOrder(newOrder);
+    };
+
+    column->onFindSimilar = [this, column](const juce::File& file) {
+        showSimilarGrooves(folderColumns.indexOf(column), file);
+    };
+
+    column->onShowDuplicates = [this, column](const juce::File& file) {
+        showDuplicates(folderColumns.indexOf(column), file);
+    };
+
+    column->setCollapseDuplicates(collapseDuplicates);
+    column->onCollapseDuplicatesChange = [this](bool shouldCollapse) {
+        collapseDuplicates = shouldCollapse;
+        for (auto* other : folderColumns)
+            other->setCollapseDuplicates(shouldCollapse);
+        refreshListings();
+    };
+
     column->setSize(isFileColumn ? FILE_COLUMN_WIDTH : FOLDER_COLUMN_WIDTH, COLUMN_HEIGHT_MIN);
 
     folderColumns.add(column);
@@ -1077,6 +1394,8 @@ void GrooveBrowser::addFolderColumn(const juce::String& title, bool isFileColumn
 
 void GrooveBrowser::removeFolderColumnsAfter(int index)
 {
+    cancelFolderListings(index + 1);
+
     while (folderColumns.size() > index + 1)
     {
         folderColumns.removeLast();
@@ -1152,35 +1471,190 @@ void GrooveBrowser::updateColumnsLayout()
     columnsContainer.setBounds(0, 0, totalWidth, getHeight() - 35);
 }
 
-void GrooveBrowser::scanFolder(const juce::File& folder, BrowserColumn* column)
+//==============================================================================
+// Lists one folder on the listing pool and streams the items to its column in
+// chunks. Folders that the library index has seen unchanged are listed from the
+// index snapshot without touching the filesystem. With a facet filter active,
+// only files that pass it are listed.
+class GrooveBrowser::FolderListingJob : public juce::ThreadPoolJob
 {
-    juce::StringArray items;
-    juce::Array<bool> isFolder;
-    juce::Array<juce::File> filePaths;
+public:
+    FolderListingJob(const juce::File& folderToList, BrowserColumn* targetColumn,
+                     GrooveLibraryIndex::Snapshot::Ptr indexSnapshot,
+                     std::shared_ptr<const FilterMatches> activeFilter,
+                     bool shouldCollapseDuplicates)
+        : juce::ThreadPoolJob("Folder listing"),
+          folder(folderToList), column(targetColumn),
+          listingGeneration(targetColumn->getListingGeneration()),
+          snapshot(activeFilter != nullptr ? activeFilter->snapshot : std::move(indexSnapshot)),
+          filter(std::move(activeFilter)),
+          collapseDuplicates(shouldCollapseDuplicates)
+    {
+    }
+
+    bool isListingInto(const BrowserColumn* target) const { return column.getComponent() == target; }
+
+    JobStatus runJob() override
+    {
+        if (!listFromIndex())
+            listFromFileSystem();
+
+        if (!shouldExit())
+            flush();
+
+        return jobHasFinished;
+    }
+
+private:
+    static constexpr int chunkSize = 128;
+
+    bool listFromIndex()
+    {
+        if (snapshot == nullptr)
+            return false;
+
+        const int directoryRow = snapshot->indexOfDirectory(folder);
+        if (directoryRow < 0
+            || snapshot->getDirectoryModificationTime(directoryRow) != folder.getLastModificationTime().toMilliseconds())
+            return false;
+
+        for (const auto& child : snapshot->getChildDirectories(folder))
+            addPath(juce::File(child), true, 0.0);
+
+        // Indexed files are passed on as row numbers into the snapshot's string table
+        for (int row : snapshot->getRowsInDirectory(folder))
+        {
+            if (shouldExit())
+                break;
+
+            if (filter == nullptr || filter->matches[static_cast<size_t>(row)] != 0)
+                addIndexed(row);
+        }
+
+        return true;
+    }
+
+    void listFromFileSystem()
+    {
+        for (const auto& entry : juce::RangedDirectoryIterator(folder, false, "*", juce::File::findFilesAndDirectories))
+        {
+            if (shouldExit())
+                return;
+
+            const juce::File file = entry.getFile();
+
+            if (entry.isDirectory())
+            {
+                addPath(file, true, 0.0);
+            }
+            else if (file.hasFileExtension(".mid;.midi"))
+            {
+                const int row = snapshot != nullptr ? snapshot->indexOf(file) : -1;
 
-    // Get subdirectories
-    auto subdirs = folder.findChildFiles(juce::File::findDirectories, false);
-    subdirs.sort();
+                if (filter != nullptr && (row < 0 || filter->matches[static_cast<size_t>(row)] == 0))
+                    continue;
 
-    for (const auto& dir : subdirs)
+                if (row >= 0)
+                {
+                    addIndexed(row);
+                }
+                else
+                {
+                    // Tempo of an unindexed file, without opening it
+                    addPath(file, false, GrooveLibraryIndex::extractBpmFromFileName(file.getFileNameWithoutExtension()));
+                }
+            }
+        }
+    }
+
+    void addPath(const juce::File& file, bool isFolder, double bpm)
     {
-        items.add(dir.getFileName());
-        isFolder.add(true);
-        filePaths.add(dir);  // Add directory path
+        pending.addPath(file, isFolder, bpm);
+        flushIfFull();
     }
 
-    // Get MIDI files - NO BPM formatting, just plain filename
-    auto files = folder.findChildFiles(juce::File::findFiles, false, "*.mid;*.midi");
-    files.sort();
+    void addIndexed(int row)
+    {
+        if (collapseDuplicates && !isFirstCopy(*snapshot, row, listedGrooves))
+            return;
+
+        pending.addIndexed(row, false, snapshot->getBpm(row));
+        flushIfFull();
+    }
+
+    void flushIfFull()
+    {
+        if (pending.items.size() >= static_cast<size_t>(chunkSize))
+            flush();
+    }
 
-    for (const auto& file : files)
+    void flush()
     {
-        items.add(file.getFileNameWithoutExtension()); // Just the filename without extension, no BPM info
-        isFolder.add(false);
-        filePaths.add(file);  // Add actual file path
+        if (pending.items.empty())
+            return;
+
+        pending.snapshot = snapshot;
+
+        juce::MessageManager::callAsync([target = column, generation = listingGeneration, batch = std::move(pending)]() mutable
+        {
+            // The column is gone if the user navigated elsewhere in the meantime, and
+            // has been cleared for a newer listing if the library was refreshed
+            if (auto* targetColumn = target.getComponent())
+                if (targetColumn->getListingGeneration() == generation)
+                    targetColumn->addItems(std::move(batch));
+        });
+
+        pending = {};
     }
 
-    column->setItems(items, isFolder, filePaths);
+    const juce::File folder;
+    const juce::Component::SafePointer<BrowserColumn> column;
+    const juce::uint32 listingGeneration;
+    const GrooveLibraryIndex::Snapshot::Ptr snapshot;
+    const std::shared_ptr<const FilterMatches> filter;
+    const bool collapseDuplicates;
+    std::unordered_set<juce::uint64> listedGrooves;
+
+    BrowserColumn::ItemBatch pending;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FolderListingJob)
+};
+
+void GrooveBrowser::scanFolder(const juce::File& folder, BrowserColumn* column)
+{
+    listingPool.addJob(new FolderListingJob(folder, column,
+                                            processor.drumLibraryManager.getLibraryIndex().getSnapshot(),
+                                            filterMatches, collapseDuplicates),
+                       true);
+}
+
+void GrooveBrowser::cancelFolderListings(int firstColumnIndex)
+{
+    struct ColumnSelector : public juce::ThreadPool::JobSelector
+    {
+        ColumnSelector(const GrooveBrowser& b, int first) : browser(b), firstColumn(first) {}
+
+        bool isJobSuitable(juce::ThreadPoolJob* job) override
+        {
+            auto* listing = dynamic_cast<FolderListingJob*>(job);
+            if (listing == nullptr)
+                return false;
+
+            for (int i = 0; i < firstColumn && i < browser.folderColumns.size(); ++i)
+                if (listing->isListingInto(browser.folderColumns[i]))
+                    return false;
+
+            return true;
+        }
+
+        const GrooveBrowser& browser;
+        const int firstColumn;
+    };
+
+    // Don't wait for a job that is blocked on a slow volume - it stops at its
+    // next entry and its results are dropped along with its column
+    ColumnSelector selector(*this, firstColumnIndex);
+    listingPool.removeAllJobs(true, 0, &selector);
 }
 
 void GrooveBrowser::navigateToFolder(const juce::File& folder, int columnIndex)
@@ -1232,22 +1706,13 @@ void GrooveBrowser::handleColumnSelection(int columnIndex)
         handleFileSelection(selectedFile);
         
         // Determine source library from root folder
-        DrumLibrary sourceLib = DrumLibrary::Unknown;
-        for (int i = 0; i < processor.drumLibraryManager.getNumRootFolders(); ++i)
-        {
-            auto rootFolder = processor.drumLibraryManager.getRootFolder(i);
-            if (selectedFile.getFullPathName().startsWith(rootFolder.getFullPathName()))
-            {
-                sourceLib = processor.drumLibraryManager.getRootFolderSourceLibrary(i);
-                currentSourceLibrary = sourceLib;
-                break;
-            }
-        }
+        DrumLibrary sourceLib = processor.drumLibraryManager.getSourceLibraryFor(selectedFile);
+        currentSourceLibrary = sourceLib;
 
         DrumLibrary targetLib = getCurrentTargetLibrary();
 
         // Use dissectMidiFileWithLibraryManager
-        currentDrumParts = midiDissector.dissectMidiFileWithLibraryManager(currentMidiFile, sourceLib, targetLib, processor.drumLibraryManager);
+        currentDrumParts = processor.dissectionCache.getDrumParts(currentMidiFile, sourceLib, targetLib);
 
         if (!currentDrumParts.isEmpty())
         {
@@ -1273,23 +1738,362 @@ void GrooveBrowser::handleColumnSelection(int columnIndex)
     }
 }
 
+void GrooveBrowser::updateSearchResults()
+{
+    const juce::String query = searchBox.getText().trim();
+
+    if (query.isEmpty())
+    {
+        if (isShowingSearchResults)
+        {
+            isShowingSearchResults = false;
+
+            // Back to where the user was browsing
+            cancelFolderListings(0);
+            folderColumns.clear();
+            removePartsColumn();
+
+            if (currentPath.exists())
+                loadFolderContents(currentPath);
+            else
+                updateColumnsLayout();
+        }
+        return;
+    }
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+    // Ask for more when filtering, most of them may be filtered out
+    constexpr int maxResults = 200;
+    auto results = processor.drumLibraryManager.getSearchIndex().search(query, filterMatches != nullptr ? maxResults * 20 : maxResults);
+
+    if (filterMatches != nullptr)
+    {
+        results.erase(std::remove_if(results.begin(), results.end(), [this](const GrooveSearchResult& result)
+                      {
+                          return !result.isFolder && !filterMatches->contains(result.file);
+                      }),
+                      results.end());
+
+        if (results.size() > static_cast<size_t>(maxResults))
+            results.resize(static_cast<size_t>(maxResults));
+    }
+
+    DBG("Search '" + query + "': " + juce::String(static_cast<int>(results.size())) + " results in "
+        + juce::String(juce::Time::getMillisecondCounterHiRes() - startTime, 2) + " ms");
+
+    if (!isShowingSearchResults || folderColumns.isEmpty())
+    {
+        cancelFolderListings(0);
+        folderColumns.clear();
+        removePartsColumn();
+        navigationPath.clear();
+        addFolderColumn("Search", true);
+        isShowingSearchResults = true;
+        shownCollectionId.clear();
+    }
+    else
+    {
+        removeFolderColumnsAfter(0);
+    }
+
+    BrowserColumn::ItemBatch batch;
+    batch.snapshot = processor.drumLibraryManager.getLibraryIndex().getSnapshot();
+
+    std::unordered_set<juce::uint64> listedGrooves;
+
+    for (const auto& result : results)
+    {
+        const int row = result.isFolder ? -1 : batch.snapshot->indexOf(result.file);
+
+        if (row >= 0)
+        {
+            if (!collapseDuplicates || isFirstCopy(*batch.snapshot, row, listedGrooves))
+                batch.addIndexed(row, false, batch.snapshot->getBpm(row));
+        }
+        else
+        {
+            batch.addPath(result.file, result.isFolder, 0.0);
+        }
+    }
+
+    // Results stay in rank order
+    auto* column = folderColumns.getFirst();
+    column->deselectAllRows();
+    column->setItems(std::move(batch));
+    column->scrollToEnsureRowIsOnscreen(0);
+}
+
+void GrooveBrowser::showSimilarGrooves(int columnIndex, const juce::File& file)
+{
+    if (columnIndex < 0 || columnIndex >= folderColumns.size())
+        return;
+
+    auto snapshot = processor.drumLibraryManager.getLibraryIndex().getSnapshot();
+    const int row = snapshot->indexOf(file);
+
+    if (row < 0)
+    {
+        DBG("Find similar: " + file.getFileName() + " is not indexed yet");
+        return;
+    }
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+    // Ask for more when filtering, most of them may be filtered out
+    constexpr int maxResults = 100;
+    auto results = snapshot->findSimilar(snapshot->getFingerprint(row),
+                                         filterMatches != nullptr || collapseDuplicates ? maxResults * 20 : maxResults, row);
+
+    // Copies of the groove itself are not alternatives to it
+    std::unordered_set<juce::uint64> listedGrooves { snapshot->getOnsetHash(row) };
+
+    results.erase(std::remove_if(results.begin(), results.end(), [&](const SimilarGroove& result)
+                  {
+                      if (collapseDuplicates && !isFirstCopy(*snapshot, result.row, listedGrooves))
+                          return true;
+                      if (filterMatches == nullptr)
+                          return false;
+                      if (filterMatches->snapshot == snapshot)
+                          return filterMatches->matches[static_cast<size_t>(result.row)] == 0;
+                      return !filterMatches->contains(juce::File(snapshot->getPath(result.row)));
+                  }),
+                  results.end());
+
+    if (results.size() > static_cast<size_t>(maxResults))
+        results.resize(static_cast<size_t>(maxResults));
+
+    DBG("Similar to '" + file.getFileName() + "': " + juce::String(static_cast<int>(results.size())) + " of "
+        + juce::String(snapshot->size()) + " grooves in "
+        + juce::String(juce::Time::getMillisecondCounterHiRes() - startTime, 2) + " ms");
+
+    std::vector<int> rows;
+    rows.reserve(results.size());
+    for (const auto& result : results)
+        rows.push_back(result.row);
+
+    // Closest first
+    showRowsInColumn(columnIndex, "Similar to " + formatFileName(file.getFileName(), true), snapshot, rows);
+}
+
+void GrooveBrowser::showDuplicates(int columnIndex, const juce::File& file)
+{
+    if (columnIndex < 0 || columnIndex >= folderColumns.size())
+        return;
+
+    auto snapshot = processor.drumLibraryManager.getLibraryIndex().getSnapshot();
+    const int row = snapshot->indexOf(file);
+    if (row < 0)
+        return;
+
+    const auto copies = snapshot->findDuplicates(row);
+
+    // Exact copies first, then the ones that only differ in velocities
+    std::vector<int> rows(copies.begin(), copies.end());
+    const auto contentHash = snapshot->getContentHash(row);
+    std::stable_partition(rows.begin(), rows.end(), [&snapshot, contentHash](int copy)
+    {
+        return snapshot->getContentHash(copy) == contentHash;
+    });
+
+    DBG("Copies of '" + file.getFileName() + "': " + juce::String(static_cast<int>(rows.size())));
+
+    showRowsInColumn(columnIndex, "Copies of " + formatFileName(file.getFileName(), true), snapshot, rows);
+}
+
+void GrooveBrowser::showRowsInColumn(int columnIndex, const juce::String& title,
+                                     const GrooveLibraryIndex::Snapshot::Ptr& snapshot, const std::vector<int>& rows)
+{
+    // Results open in a column right of the one that was clicked
+    removeFolderColumnsAfter(columnIndex);
+    addFolderColumn(title, true);
+
+    BrowserColumn::ItemBatch batch;
+    batch.snapshot = snapshot;
+
+    for (int row : rows)
+        batch.addIndexed(row, false, snapshot->getBpm(row));
+
+    auto* column = folderColumns.getLast();
+    column->setItems(std::move(batch));
+    column->scrollToEnsureRowIsOnscreen(0);
+}
+
+void GrooveBrowser::showCollection(const juce::String& collectionId)
+{
+    auto& favorites = processor.favoritesManager;
+
+    juce::String title;
+    for (int i = 0; i < favorites.getNumSmartCollections(); ++i)
+        if (favorites.getSmartCollection(i).id == collectionId)
+            title = favorites.getSmartCollection(i).name;
+
+    if (title.isEmpty())
+        return;
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    auto snapshot = processor.drumLibraryManager.getLibraryIndex().getSnapshot();
+    auto rows = favorites.getCollectionRows(collectionId, snapshot);
+
+    if (collapseDuplicates)
+    {
+        std::unordered_set<juce::uint64> listedGrooves;
+        rows.erase(std::remove_if(rows.begin(), rows.end(), [&snapshot, &listedGrooves](int row)
+                   {
+                       return !isFirstCopy(*snapshot, row, listedGrooves);
+                   }),
+                   rows.end());
+    }
+
+    DBG("Collection '" + title + "': " + juce::String(static_cast<int>(rows.size())) + " grooves in "
+        + juce::String(juce::Time::getMillisecondCounterHiRes() - startTime, 2) + " ms");
+
+    isShowingSearchResults = false;
+    shownCollectionId = collectionId;
+    showRowsInColumn(-1, title, snapshot, rows);
+}
+
+void GrooveBrowser::saveFilterAsCollection(const GrooveFilter& filter)
+{
+    juce::AlertWindow w("Save as Collection", "The collection lists every groove matching the filter.",
+                        juce::AlertWindow::NoIcon);
+    w.addTextEditor("name", "New Collection", "Name:");
+    w.addTextEditor("tags", "", "Tags (comma separated):");
+    w.addComboBox("files", { "All files", "Favorite files only" }, "Files:");
+    w.addButton("Save", 1, juce::KeyPress(juce::KeyPress::returnKey));
+    w.addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+
+    if (w.runModalLoop() != 1)
+        return;
+
+    SmartCollection collection;
+    collection.name = w.getTextEditorContents("name").trim();
+    collection.filter = filter;
+    collection.tags.addTokens(w.getTextEditorContents("tags"), ",", "");
+    collection.tags.trim();
+    collection.tags.removeEmptyStrings();
+    collection.favoritesOnly = w.getComboBoxComponent("files")->getSelectedItemIndex() == 1;
+
+    if (collection.name.isEmpty())
+        return;
+
+    showCollection(processor.favoritesManager.addSmartCollection(collection));
+}
+
+bool GrooveBrowser::isFirstCopy(const GrooveLibraryIndex::Snapshot& snapshot, int row,
+                                std::unordered_set<juce::uint64>& listedGrooves)
+{
+    const auto onsetHash = snapshot.getOnsetHash(row);
+    return onsetHash == 0 || listedGrooves.insert(onsetHash).second;
+}
+
+void GrooveBrowser::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+    // New thumbnails were rendered
+    if (source == &processor.drumLibraryManager.getThumbnailCache())
+    {
+        for (auto* column : folderColumns)
+            column->repaint();
+        return;
+    }
+
+    // A listed collection follows the index and the file marks, unless the user is working with it
+    if (shownCollectionId.isNotEmpty() && !folderColumns.isEmpty() && folderColumns.getFirst()->getSelectedRow() < 0)
+        showCollection(shownCollectionId);
+
+    if (source == &processor.favoritesManager)
+        return;
+
+    // The index changed underneath the filter
+    if (filterMatches != nullptr)
+        updateFilterMatches();
+
+    // The search index was rebuilt - refresh the results unless the user is working with them
+    if (isShowingSearchResults && !folderColumns.isEmpty() && folderColumns.getFirst()->getSelectedRow() < 0)
+        updateSearchResults();
+}
+
+void GrooveBrowser::showFilterPanel()
+{
+    auto panel = std::make_unique<GrooveFilterPanel>(activeFilter);
+    panel->onFilterChanged = [safeThis = juce::Component::SafePointer<GrooveBrowser>(this)](const GrooveFilter& filter)
+    {
+        if (safeThis != nullptr)
+            safeThis->setFilter(filter);
+    };
+    panel->onSaveAsCollection = [safeThis = juce::Component::SafePointer<GrooveBrowser>(this)](const GrooveFilter& filter)
+    {
+        juce::MessageManager::callAsync([safeThis, filter]()
+        {
+            if (safeThis != nullptr)
+                safeThis->saveFilterAsCollection(filter);
+        });
+    };
+
+    juce::CallOutBox::launchAsynchronously(std::move(panel), filterButton.getScreenBounds(), nullptr);
+}
+
+void GrooveBrowser::setFilter(const GrooveFilter& newFilter)
+{
+    activeFilter = newFilter;
+    updateFilterMatches();
+
+    filterButton.setButtonText(activeFilter.isActive() ? "Filter *" : "Filter");
+    refreshListings();
+}
+
+void GrooveBrowser::updateFilterMatches()
+{
+    if (!activeFilter.isActive())
+    {
+        filterMatches.reset();
+        return;
+    }
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    auto newMatches = std::make_shared<FilterMatches>();
+    newMatches->snapshot = processor.drumLibraryManager.getLibraryIndex().getSnapshot();
+    newMatches->matches = newMatches->snapshot->filter(activeFilter);
+    filterMatches = std::move(newMatches);
+
+    DBG("Filter evaluated over " + juce::String(filterMatches->snapshot->size()) + " grooves in "
+        + juce::String(juce::Time::getMillisecondCounterHiRes() - startTime, 2) + " ms");
+}
+
+void GrooveBrowser::refreshListings()
+{
+    if (isShowingSearchResults)
+    {
+        updateSearchResults();
+        return;
+    }
+
+    // Re-list every open column in place, keeping its selection
+    cancelFolderListings(0);
+
+    for (int i = 0; i < folderColumns.size() && i < navigationPath.size(); ++i)
+    {
+        folderColumns[i]->clearItemsKeepingSelection();
+        scanFolder(navigationPath[i], folderColumns[i]);
+    }
+}
+
 void GrooveBrowser::showFolderContextMenu(const juce::File& folder)
 {
     // This function is now handled directly in BrowserColumn::showContextMenu
     // for better positioning at the mouse click location
 }
 
-juce::String GrooveBrowser::formatFileName(const juce::String& filename, bool isMidiFile) const
+juce::String GrooveBrowser::formatFileName(const juce::String& filename, bool isMidiFile)
 {
-    // Just return the filename as-is (no BPM formatting)
-    return filename;
+    // MIDI files are listed without extension - the BPM is drawn in its own column
+    return isMidiFile ? filename.upToLastOccurrenceOf(".", false, false) : filename;
 }
 
-int GrooveBrowser::extractBPMFromFilename(const juce::String& filename) const
+int GrooveBrowser::extractBPMFromFilename(const juce::String& filename)
 {
-    // Extract BPM from filename if present
-    // This is probably used elsewhere in the original code
-    return 120; // Default BPM
+    const double bpm = GrooveLibraryIndex::extractBpmFromFileName(formatFileName(filename, true));
+    return bpm > 0.0 ? juce::roundToInt(bpm) : 120; // Default BPM
 }
 
 
@@ -1311,16 +2115,16 @@ void BrowserColumn::listBoxItemClicked(int row, const juce::MouseEvent& e)
 
 void BrowserColumn::showContextMenu(int row, const juce::Point<int>& position)
 {
-    if (row < 0 || row >= items.size())
+    if (row < 0 || row >= getNumItems())
         return;
     
     // Get actual mouse screen position
     auto mousePos = juce::Desktop::getInstance().getMainMouseSource().getScreenPosition();
     
     // Handle folders - show folder context menu
-    if (itemIsFolder[row])
+    if (isItemFolder(row))
     {
-        juce::File folder = itemFiles[row];
+        juce::File folder = getItemFile(row);
         if (folder.exists() && folder.isDirectory() && onRightClickFolder)
         {
             juce::PopupMenu menu;
@@ -1360,7 +2164,7 @@ void BrowserColumn::showContextMenu(int row, const juce::Point<int>& position)
     }
     
     // Handle MIDI files
-    juce::File midiFile = itemFiles[row];
+    juce::File midiFile = getItemFile(row);
     if (!midiFile.existsAsFile())
         return;
     
@@ -1368,6 +2172,30 @@ void BrowserColumn::showContextMenu(int row, const juce::Point<int>& position)
     menu.addItem(1, "Export to Desktop...");
     menu.addSeparator();
     menu.addItem(2, "Show in Explorer");
+    menu.addSeparator();
+    menu.addItem(3, "Sort by Name", true, sortOrder == SortOrder::Name);
+    menu.addItem(4, "Sort by BPM", true, sortOrder == SortOrder::Bpm);
+    menu.addSeparator();
+    menu.addItem(5, "Find Similar Grooves", onFindSimilar != nullptr);
+
+    const auto& item = items[static_cast<size_t>(row)];
+    const int numCopies = item.isIndexed ? static_cast<int>(snapshot->findDuplicates(item.pathRef).size()) - 1 : 0;
+    menu.addItem(6, "Show Copies (" + juce::String(juce::jmax(0, numCopies)) + ")", numCopies > 0 && onShowDuplicates != nullptr);
+    menu.addItem(7, "Collapse Copies", true, collapseDuplicates);
+    menu.addSeparator();
+
+    // Per-file marks, used by smart collections
+    auto& favorites = processor.favoritesManager;
+    const auto fileTags = favorites.getFileTags(midiFile);
+    menu.addItem(8, "Favorite", true, favorites.isFileFavorite(midiFile));
+
+    juce::PopupMenu tagsMenu;
+    for (int i = 0; i < favorites.getAllTags().size(); ++i)
+        tagsMenu.addItem(100 + i, favorites.getAllTags()[i], true, fileTags.contains(favorites.getAllTags()[i]));
+    if (tagsMenu.getNumItems() > 0)
+        tagsMenu.addSeparator();
+    tagsMenu.addItem(9, "New Tag...");
+    menu.addSubMenu("Tags", tagsMenu);
     
     // Show menu at actual mouse position
     menu.showMenuAsync(juce::PopupMenu::Options()
@@ -1383,6 +2211,49 @@ void BrowserColumn::showContextMenu(int row, const juce::Point<int>& position)
             {
                 midiFile.revealToUser();
             }
+            else if (result == 3 || result == 4)
+            {
+                const auto newOrder = result == 3 ? SortOrder::Name : SortOrder::Bpm;
+                setSortOrder(newOrder);
+
+                if (onSortOrderChange)
+                    onSortOrderChange(newOrder);
+            }
+            else if (result == 5 && onFindSimilar)
+            {
+                onFindSimilar(midiFile);
+            }
+            else if (result == 6 && onShowDuplicates)
+            {
+                onShowDuplicates(midiFile);
+            }
+            else if (result == 7)
+            {
+                collapseDuplicates = !collapseDuplicates;
+
+                if (onCollapseDuplicatesChange)
+                    onCollapseDuplicatesChange(collapseDuplicates);
+            }
+            else if (result == 8)
+            {
+                processor.favoritesManager.setFileFavorite(midiFile, !processor.favoritesManager.isFileFavorite(midiFile));
+            }
+            else if (result == 9)
+            {
+                juce::AlertWindow w("New Tag", "Tag " + midiFile.getFileName() + " as:", juce::AlertWindow::NoIcon);
+                w.addTextEditor("tag", "");
+                w.addButton("Add", 1, juce::KeyPress(juce::KeyPress::returnKey));
+                w.addButton("Cancel", 0, juce::KeyPress(juce::KeyPress::escapeKey));
+
+                if (w.runModalLoop() == 1)
+                    processor.favoritesManager.setFileTag(midiFile, w.getTextEditorContents("tag"), true);
+            }
+            else if (result >= 100)
+            {
+                const auto tag = processor.favoritesManager.getAllTags()[result - 100];
+                const bool hasTag = processor.favoritesManager.getFileTags(midiFile).contains(tag);
+                processor.favoritesManager.setFileTag(midiFile, tag, !hasTag);
+            }
         });
 }
 
@@ -3,6 +3,11 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "../../Core/MidiDissector.h"
+#include "../../Core/GrooveLibraryIndex.h"
+#include "RowHoverTracker.h"
+#include <array>
+#include <unordered_set>
+#include <vector>
 
 // Forward declarations
 class DrumGrooveProcessor;
@@ -33,6 +38,28 @@ private:
 class BrowserColumn : public juce::ListBox, public juce::ListBoxModel
 {
 public:
+    enum class SortOrder { Name, Bpm };
+
+    // One listed folder or file. Indexed files point into the library index's
+    // string table; everything else into the column's own path pool.
+    struct Item
+    {
+        juce::int32 pathRef = 0;       // Snapshot file row if isIndexed, otherwise index into localPaths
+        float bpm = 0.0f;              // 0 for folders and files without a known tempo
+        bool isFolder = false;
+        bool isIndexed = false;
+    };
+
+    struct ItemBatch
+    {
+        GrooveLibraryIndex::Snapshot::Ptr snapshot;    // What indexed items refer to
+        std::vector<Item> items;
+        juce::StringArray localPaths;                  // What the other items refer to
+
+        void addIndexed(int snapshotRow, bool isFolder, double bpm);
+        void addPath(const juce::File& file, bool isFolder, double bpm);
+    };
+
     explicit BrowserColumn(const juce::String& columnName, DrumGrooveProcessor& proc);
     ~BrowserColumn() override;
 
@@ -49,27 +76,79 @@ public:
     // NEW: Public method called by DraggableListItemOverlay
     void startExternalDrag(int rowNumber);
 
-    void setItems(const juce::StringArray& items, const juce::Array<bool>& isFolder, const juce::Array<juce::File>& filePaths = {});
+    // Replaces the items, keeping the batch order
+    void setItems(ItemBatch batch);
+    // Merges more items into the column (folders first, then files in sort order), keeping the selection
+    void addItems(ItemBatch batch);
     void clearItems();
+    // Clears the column but reselects the current file once addItems brings it back
+    void clearItemsKeepingSelection();
+    // Bumped whenever the items are replaced, so batches of an earlier listing can be told apart
+    juce::uint32 getListingGeneration() const { return listingGeneration; }
     juce::String getSelectedItem() const;
     bool isSelectedItemFolder() const;
     juce::File getSelectedFile() const;
     int getSelectedRow() const { return selectedRow; }
 
+    int getNumItems() const { return static_cast<int>(items.size()); }
+    juce::String getItemName(int row) const;
+    juce::File getItemFile(int row) const;
+    bool isItemFolder(int row) const;
+    double getItemBpm(int row) const;
+
+    void setSortOrder(SortOrder newOrder);
+    SortOrder getSortOrder() const { return sortOrder; }
+
+    // Only shows the menu state; the browser does the collapsing when it lists
+    void setCollapseDuplicates(bool shouldCollapse) { collapseDuplicates = shouldCollapse; }
+
     juce::var getDragSourceDescription(const juce::SparseSet<int>& selectedRows) override;
 
     // Callbacks
     std::function<void()> onSelectionChange;
     std::function<void(int)> onDoubleClick;
     std::function<void(const juce::File&)> onRightClickFolder;
-
-    // Public members for display
-    juce::StringArray items;
-    juce::Array<bool> itemIsFolder;
-    juce::Array<juce::File> itemFiles;
+    std::function<void(SortOrder)> onSortOrderChange;
+    std::function<void(const juce::File&)> onFindSimilar;
+    std::function<void(const juce::File&)> onShowDuplicates;
+    std::function<void(bool)> onCollapseDuplicatesChange;
 
 private:
     void loadIcons();
+    void appendBatch(ItemBatch&& batch);
+    void sortItems();
+    void itemsReordered(const juce::File& selectedFile);
+
+    struct ItemOrder
+    {
+        const BrowserColumn& column;
+        bool operator()(const Item& a, const Item& b) const noexcept;
+    };
+    int findItem(const juce::File& file) const;
+    const char* getItemPath(const Item& item, size_t& length) const noexcept;
+
+    // Laid-out text of recently painted rows, so scrolling doesn't re-shape text
+    struct CachedRowText
+    {
+        int row = -1;
+        int width = 0;
+        juce::uint32 contentVersion = 0;
+        juce::GlyphArrangement name;
+        juce::GlyphArrangement bpm;
+        juce::uint64 thumbnailHash = 0;               // 0 = no thumbnail
+        juce::Rectangle<int> thumbnailArea;
+    };
+
+    const CachedRowText& getRowText(int row, int width, int height);
+
+    std::vector<Item> items;
+    GrooveLibraryIndex::Snapshot::Ptr snapshot;
+    juce::StringArray localPaths;
+
+    std::array<CachedRowText, 128> rowTextCache;      // Slot = row % size
+    juce::uint32 contentVersion = 1;                  // Bumped whenever rows change
+    juce::uint32 listingGeneration = 0;
+    juce::Font rowFont;
     
     // Context menu methods
     void showContextMenu(int row, const juce::Point<int>& position);
@@ -77,6 +156,9 @@ private:
     
     juce::String columnTitle;
     int selectedRow = -1;
+    juce::File pendingSelection;
+    SortOrder sortOrder = SortOrder::Name;
+    bool collapseDuplicates = false;
     juce::Image folderIcon;
     juce::Image midiIcon;
     
@@ -87,6 +169,8 @@ private:
     bool isExternalDragActive = false;
     juce::File lastTempDragFile;
 
+    RowHoverTracker hoverTracker { *this };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BrowserColumn)
 };
 
@@ -94,6 +178,8 @@ class GrooveBrowser : public juce::Component,
                      public juce::DragAndDropContainer,
                      public juce::ComboBox::Listener,
                      public juce::AudioProcessorValueTreeState::Listener,
+                     private juce::ChangeListener,
+                     private juce::AsyncUpdater,
                      private juce::Timer
 {
 public:
@@ -118,7 +204,6 @@ public:
     void handleDrumPartDoubleClick(const DrumPart& part);
 
     bool keyPressed(const juce::KeyPress& key) override;
-    void timerCallback() override;
 
     // File selection callback for main component
     std::function<void(const juce::File&)> onFileSelected;
@@ -128,23 +213,35 @@ public:
     juce::Array<juce::File> getNavigationPath() const { return navigationPath; }
     void restoreNavigationState(const juce::File& folder, const juce::Array<juce::File>& path);
 
+    // Lists a smart collection in place of the open folders
+    void showCollection(const juce::String& collectionId);
+
+    // Name shown for a listed file or folder
+    static juce::String formatFileName(const juce::String& filename, bool isMidiFile);
+
 private:
     DrumGrooveProcessor& processor;
 	
 	// BPM monitoring for real-time updates
 	double lastKnownBPM = 120.0;
+    void handleAsyncUpdate() override;
+    void timerCallback() override;
+    void updatePlaybackBPM();
 
     // Column management
     juce::OwnedArray<BrowserColumn> folderColumns;
     std::unique_ptr<DrumPartsColumn> partsColumn;
 
+    // Folder listings run here and stream their results into the columns
+    class FolderListingJob;
+    juce::ThreadPool listingPool { 2 };
+
     juce::Viewport viewport;
     juce::Component columnsContainer;
     juce::File currentPath;
     juce::Array<juce::File> navigationPath;
 
     // MIDI dissection
-    MidiDissector midiDissector;
     juce::File currentMidiFile;
     juce::Array<DrumPart> currentDrumParts;
     DrumLibrary currentSourceLibrary = DrumLibrary::Unknown;
@@ -156,6 +253,49 @@ private:
     juce::Label targetLibraryLabel;
     juce::ComboBox targetLibraryCombo;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> libraryAttachment;
+
+    // Library search - results replace the folder columns while the box has text
+    juce::TextEditor searchBox;
+    bool isShowingSearchResults = false;
+    void updateSearchResults();
+
+    // Facet filter - while active only indexed files that pass it are listed
+    struct FilterMatches
+    {
+        GrooveLibraryIndex::Snapshot::Ptr snapshot;
+        std::vector<juce::uint8> matches;
+
+        bool contains(const juce::File& file) const
+        {
+            const int row = snapshot->indexOf(file);
+            return row >= 0 && matches[static_cast<size_t>(row)] != 0;
+        }
+    };
+
+    juce::TextButton filterButton { "Filter" };
+    GrooveFilter activeFilter;
+    std::shared_ptr<const FilterMatches> filterMatches;
+    void showFilterPanel();
+    void setFilter(const GrooveFilter& newFilter);
+    void updateFilterMatches();
+    void refreshListings();
+
+    // Nearest grooves to a file by rhythm fingerprint, in a column right of columnIndex
+    void showSimilarGrooves(int columnIndex, const juce::File& file);
+    // Every copy of a file in the library, in a column right of columnIndex
+    void showDuplicates(int columnIndex, const juce::File& file);
+    void showRowsInColumn(int columnIndex, const juce::String& title,
+                          const GrooveLibraryIndex::Snapshot::Ptr& snapshot, const std::vector<int>& rows);
+
+    juce::String shownCollectionId;   // Re-listed when the index or the marks change
+    void saveFilterAsCollection(const GrooveFilter& filter);
+
+    // With collapsing on, only the first listed copy of a groove is shown
+    bool collapseDuplicates = false;
+    static bool isFirstCopy(const GrooveLibraryIndex::Snapshot& snapshot, int row,
+                            std::unordered_set<juce::uint64>& listedGrooves);
+
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
     
     // Helper methods
     DrumLibrary getCurrentTargetLibrary() const;
@@ -178,11 +318,12 @@ private:
     void updateColumnsLayout();
 
     void scanFolder(const juce::File& folder, BrowserColumn* column);
+    void cancelFolderListings(int firstColumnIndex);
     void navigateToFolder(const juce::File& folder, int columnIndex);
     void handleColumnSelection(int columnIndex);
 
-    juce::String formatFileName(const juce::String& filename, bool isMidiFile) const;
-    int extractBPMFromFilename(const juce::String& filename) const;
+    static int extractBPMFromFilename(const juce::String& filename);
+    BrowserColumn::SortOrder columnSortOrder = BrowserColumn::SortOrder::Name;
     juce::File getCurrentFileForRow(int columnIndex, int row);
 	
 	bool hasInitializedTargetLibrary = false;
@@ -0,0 +1,237 @@
+#include "GrooveFilterPanel.h"
+#include "../LookAndFeel/ColourPalette.h"
+#include "../LookAndFeel/DrumGrooveLookAndFeel.h"
+
+namespace
+{
+    struct Meter
+    {
+        int numerator;
+        int denominator;
+    };
+
+    // ComboBox item n + 2 selects meters[n]; item 1 is "Any"
+    constexpr Meter meters[] = { { 4, 4 }, { 3, 4 }, { 5, 4 }, { 7, 4 }, { 6, 8 },
+                                 { 5, 8 }, { 7, 8 }, { 9, 8 }, { 12, 8 } };
+}
+
+GrooveFilterPanel::GrooveFilterPanel(const GrooveFilter& initialFilter)
+    : filter(initialFilter)
+{
+    auto& lnf = DrumGrooveLookAndFeel::getInstance();
+
+    for (auto* label : { &bpmLabel, &barsLabel, &meterLabel, &fillsLabel, &partsLabel })
+    {
+        label->setFont(lnf.getNormalFont().withHeight(13.0f));
+        label->setColour(juce::Label::textColourId, ColourPalette::secondaryText);
+        addAndMakeVisible(label);
+    }
+
+    bpmLabel.setText("BPM", juce::dontSendNotification);
+    barsLabel.setText("Bars", juce::dontSendNotification);
+    meterLabel.setText("Meter", juce::dontSendNotification);
+    fillsLabel.setText("Fills", juce::dontSendNotification);
+    partsLabel.setText("Parts (click: has / not / any)", juce::dontSendNotification);
+
+    setupRangeSlider(bpmSlider, minBpm, maxBpm,
+                     filter.minBpm > 0.0 ? filter.minBpm : minBpm,
+                     filter.maxBpm > 0.0 ? filter.maxBpm : maxBpm);
+    setupRangeSlider(barsSlider, 1.0, maxBars,
+                     filter.minBars > 0 ? filter.minBars : 1.0,
+                     filter.maxBars > 0 ? filter.maxBars : maxBars);
+
+    meterCombo.addItem("Any", 1);
+    for (int i = 0; i < static_cast<int>(std::size(meters)); ++i)
+    {
+        meterCombo.addItem(juce::String(meters[i].numerator) + "/" + juce::String(meters[i].denominator), i + 2);
+
+        if (meters[i].numerator == filter.timeSignatureNumerator && meters[i].denominator == filter.timeSignatureDenominator)
+            meterCombo.setSelectedId(i + 2, juce::dontSendNotification);
+    }
+    if (meterCombo.getSelectedId() == 0)
+        meterCombo.setSelectedId(1, juce::dontSendNotification);
+    meterCombo.onChange = [this]() { updateFilterFromControls(); };
+    addAndMakeVisible(meterCombo);
+
+    // Item ids are the GrooveFilter::fills value + 2
+    fillsCombo.addItem("Any", 2);
+    fillsCombo.addItem("Has a fill", 3);
+    fillsCombo.addItem("No fills", 1);
+    fillsCombo.setSelectedId(juce::jlimit(-1, 1, filter.fills) + 2, juce::dontSendNotification);
+    fillsCombo.onChange = [this]() { updateFilterFromControls(); };
+    addAndMakeVisible(fillsCombo);
+
+    for (int type = 0; type < static_cast<int>(DrumPartType::COUNT); ++type)
+    {
+        const auto bit = static_cast<juce::uint16>(1u << type);
+        partStates[static_cast<size_t>(type)] = (filter.requiredParts & bit) != 0 ? PartState::Present
+                                              : (filter.excludedParts & bit) != 0 ? PartState::Absent
+                                                                                  : PartState::Any;
+
+        auto* button = partButtons.add(new juce::TextButton(MidiDissector::getPartShortName(static_cast<DrumPartType>(type))));
+        button->onClick = [this, type]()
+        {
+            auto& state = partStates[static_cast<size_t>(type)];
+            state = state == PartState::Any ? PartState::Present
+                  : state == PartState::Present ? PartState::Absent
+                                                : PartState::Any;
+            updatePartButton(type);
+            updateFilterFromControls();
+        };
+        addAndMakeVisible(button);
+        updatePartButton(type);
+    }
+
+    doubleKickButton.setToggleState(filter.doubleKick, juce::dontSendNotification);
+    doubleKickButton.onClick = [this]() { updateFilterFromControls(); };
+    addAndMakeVisible(doubleKickButton);
+
+    resetButton.onClick = [this]() { resetFilter(); };
+    addAndMakeVisible(resetButton);
+
+    saveButton.onClick = [this]()
+    {
+        if (onSaveAsCollection)
+            onSaveAsCollection(filter);
+    };
+    addAndMakeVisible(saveButton);
+
+    setSize(360, 278);
+}
+
+GrooveFilterPanel::~GrooveFilterPanel() = default;
+
+void GrooveFilterPanel::setupRangeSlider(juce::Slider& slider, double minimum, double maximum, double low, double high)
+{
+    slider.setSliderStyle(juce::Slider::TwoValueHorizontal);
+    slider.setTextBoxStyle(juce::Slider::NoTextBox, true, 0, 0);
+    slider.setRange(minimum, maximum, 1.0);
+    slider.setMinAndMaxValues(low, high, juce::dontSendNotification);
+    slider.setPopupDisplayEnabled(true, true, this);
+    slider.onValueChange = [this]() { updateFilterFromControls(); };
+    addAndMakeVisible(slider);
+}
+
+void GrooveFilterPanel::updatePartButton(int partIndex)
+{
+    auto* button = partButtons[partIndex];
+    const auto state = partStates[static_cast<size_t>(partIndex)];
+    const auto type = static_cast<DrumPartType>(partIndex);
+
+    button->setColour(juce::TextButton::buttonColourId,
+                      state == PartState::Present ? MidiDissector::getPartColour(type).darker(0.3f)
+                    : state == PartState::Absent  ? ColourPalette::inputBackground
+                                                  : ColourPalette::buttonBackground);
+    button->setColour(juce::TextButton::textColourOffId,
+                      state == PartState::Absent ? ColourPalette::secondaryText.withAlpha(0.5f) : ColourPalette::primaryText);
+    button->setButtonText((state == PartState::Absent ? "no " : "") + MidiDissector::getPartShortName(type));
+}
+
+void GrooveFilterPanel::updateFilterFromControls()
+{
+    // Sliders at their ends mean "no bound"
+    filter.minBpm = bpmSlider.getMinValue() > minBpm ? bpmSlider.getMinValue() : 0.0;
+    filter.maxBpm = bpmSlider.getMaxValue() < maxBpm ? bpmSlider.getMaxValue() : 0.0;
+    filter.minBars = barsSlider.getMinValue() > 1.0 ? juce::roundToInt(barsSlider.getMinValue()) : 0;
+    filter.maxBars = barsSlider.getMaxValue() < maxBars ? juce::roundToInt(barsSlider.getMaxValue()) : 0;
+
+    const int meterIndex = meterCombo.getSelectedId() - 2;
+    filter.timeSignatureNumerator = meterIndex >= 0 ? meters[meterIndex].numerator : 0;
+    filter.timeSignatureDenominator = meterIndex >= 0 ? meters[meterIndex].denominator : 0;
+    filter.fills = fillsCombo.getSelectedId() - 2;
+    filter.doubleKick = doubleKickButton.getToggleState();
+
+    filter.requiredParts = 0;
+    filter.excludedParts = 0;
+    for (int type = 0; type < static_cast<int>(DrumPartType::COUNT); ++type)
+    {
+        const auto bit = static_cast<juce::uint16>(1u << type);
+        if (partStates[static_cast<size_t>(type)] == PartState::Present)
+            filter.requiredParts |= bit;
+        else if (partStates[static_cast<size_t>(type)] == PartState::Absent)
+            filter.excludedParts |= bit;
+    }
+
+    repaint();
+
+    if (onFilterChanged)
+        onFilterChanged(filter);
+}
+
+void GrooveFilterPanel::resetFilter()
+{
+    bpmSlider.setMinAndMaxValues(minBpm, maxBpm, juce::dontSendNotification);
+    barsSlider.setMinAndMaxValues(1.0, maxBars, juce::dontSendNotification);
+    meterCombo.setSelectedId(1, juce::dontSendNotification);
+    fillsCombo.setSelectedId(2, juce::dontSendNotification);
+    doubleKickButton.setToggleState(false, juce::dontSendNotification);
+
+    for (int type = 0; type < static_cast<int>(DrumPartType::COUNT); ++type)
+    {
+        partStates[static_cast<size_t>(type)] = PartState::Any;
+        updatePartButton(type);
+    }
+
+    updateFilterFromControls();
+}
+
+void GrooveFilterPanel::paint(juce::Graphics& g)
+{
+    g.fillAll(ColourPalette::panelBackground);
+
+    // Current range values next to the sliders
+    auto& lnf = DrumGrooveLookAndFeel::getInstance();
+    g.setFont(lnf.getNormalFont().withHeight(12.0f));
+    g.setColour(ColourPalette::primaryText);
+
+    auto rangeText = [](double low, double high, double minimum, double maximum)
+    {
+        if (low <= minimum && high >= maximum)
+            return juce::String("Any");
+        return juce::String(juce::roundToInt(low)) + " - " + juce::String(juce::roundToInt(high));
+    };
+
+    g.drawText(rangeText(bpmSlider.getMinValue(), bpmSlider.getMaxValue(), minBpm, maxBpm),
+               bpmLabel.getBounds().withX(getWidth() - 90).withWidth(80), juce::Justification::centredRight);
+    g.drawText(rangeText(barsSlider.getMinValue(), barsSlider.getMaxValue(), 1.0, maxBars),
+               barsLabel.getBounds().withX(getWidth() - 90).withWidth(80), juce::Justification::centredRight);
+}
+
+void GrooveFilterPanel::resized()
+{
+    auto bounds = getLocalBounds().reduced(8);
+
+    auto layoutRow = [&bounds](juce::Label& label, juce::Component& control)
+    {
+        auto row = bounds.removeFromTop(24);
+        label.setBounds(row.removeFromLeft(50));
+        control.setBounds(row.withTrimmedRight(90));
+        bounds.removeFromTop(4);
+    };
+
+    layoutRow(bpmLabel, bpmSlider);
+    layoutRow(barsLabel, barsSlider);
+    layoutRow(meterLabel, meterCombo);
+    layoutRow(fillsLabel, fillsCombo);
+
+    partsLabel.setBounds(bounds.removeFromTop(20));
+
+    auto buttonRow = bounds.removeFromBottom(24);
+    resetButton.setBounds(buttonRow.removeFromRight(80));
+    buttonRow.removeFromRight(6);
+    saveButton.setBounds(buttonRow.removeFromRight(150));
+    doubleKickButton.setBounds(buttonRow);
+    bounds.removeFromBottom(6);
+
+    // Part toggles in a grid of five columns
+    constexpr int columns = 5;
+    const int buttonWidth = bounds.getWidth() / columns;
+    const int buttonHeight = 24;
+
+    for (int i = 0; i < partButtons.size(); ++i)
+    {
+        partButtons[i]->setBounds(bounds.getX() + (i % columns) * buttonWidth,
+                                  bounds.getY() + (i / columns) * (buttonHeight + 3),
+                                  buttonWidth - 3, buttonHeight);
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "../../Core/GrooveLibraryIndex.h"
+#include "../../Core/MidiDissector.h"
+
+// Facet editor shown in a call-out from the browser's Filter button
+class GrooveFilterPanel : public juce::Component
+{
+public:
+    explicit GrooveFilterPanel(const GrooveFilter& initialFilter);
+    ~GrooveFilterPanel() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    GrooveFilter getFilter() const { return filter; }
+
+    std::function<void(const GrooveFilter&)> onFilterChanged;
+    std::function<void(const GrooveFilter&)> onSaveAsCollection;
+
+private:
+    enum class PartState { Any, Present, Absent };
+
+    void setupRangeSlider(juce::Slider& slider, double minimum, double maximum, double low, double high);
+    void updatePartButton(int partIndex);
+    void updateFilterFromControls();
+    void resetFilter();
+
+    GrooveFilter filter;
+
+    juce::Label bpmLabel, barsLabel, meterLabel, fillsLabel, partsLabel;
+    juce::Slider bpmSlider, barsSlider;
+    juce::ComboBox meterCombo, fillsCombo;
+    juce::OwnedArray<juce::TextButton> partButtons;
+    std::array<PartState, static_cast<size_t>(DrumPartType::COUNT)> partStates {};
+    juce::ToggleButton doubleKickButton { "Double kick" };
+    juce::TextButton resetButton { "Reset" };
+    juce::TextButton saveButton { "Save as Collection..." };
+
+    static constexpr double minBpm = 40.0, maxBpm = 300.0;
+    static constexpr int maxBars = 64;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GrooveFilterPanel)
+};
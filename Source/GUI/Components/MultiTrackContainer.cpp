@@ -1912,6 +1912,14 @@ void MultiTrackContainer::restoreGuiState(const juce::ValueTree& state)
                removeTrack(static_cast<int>(tracks.size() - 1));
        }
     
+    // Parse the clips' files in the background while the tracks are rebuilt
+    juce::Array<juce::File> clipFiles;
+    for (auto trackNode : tracksTree)
+        for (auto clipNode : trackNode.getChildWithName("Clips"))
+            clipFiles.addIfNotAlreadyThere(juce::File(clipNode.getProperty("file", "").toString()));
+
+    processor.midiFileCache.prefetch(clipFiles);
+
     // Restore each track's state and clips
     int idx = 0;
     for (auto trackNode : tracksTree)
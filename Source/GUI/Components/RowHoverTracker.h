@@ -0,0 +1,59 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+// Follows the mouse over a ListBox and repaints only the rows whose hover
+// state changed, so the list never has to be repainted on a timer
+class RowHoverTracker : private juce::MouseListener
+{
+public:
+    explicit RowHoverTracker(juce::ListBox& list) : listBox(list)
+    {
+        listBox.addMouseListener(this, true);
+    }
+
+    ~RowHoverTracker() override
+    {
+        listBox.removeMouseListener(this);
+    }
+
+    int getHoveredRow() const noexcept { return hoveredRow; }
+
+private:
+    void mouseEnter(const juce::MouseEvent& e) override { updateHoveredRow(e); }
+    void mouseMove(const juce::MouseEvent& e) override { updateHoveredRow(e); }
+    void mouseDrag(const juce::MouseEvent& e) override { updateHoveredRow(e); }
+    void mouseExit(const juce::MouseEvent& e) override { updateHoveredRow(e); }
+
+    void mouseWheelMove(const juce::MouseEvent& e, const juce::MouseWheelDetails&) override
+    {
+        // The list has scrolled underneath the pointer
+        updateHoveredRow(e);
+    }
+
+    void updateHoveredRow(const juce::MouseEvent& e)
+    {
+        const auto position = e.getEventRelativeTo(&listBox).getPosition();
+        const bool isInside = listBox.isMouseOver(true) && listBox.getLocalBounds().contains(position);
+        setHoveredRow(isInside ? listBox.getRowContainingPosition(position.x, position.y) : -1);
+    }
+
+    void setHoveredRow(int newRow)
+    {
+        if (newRow == hoveredRow)
+            return;
+
+        if (hoveredRow >= 0)
+            listBox.repaintRow(hoveredRow);
+
+        hoveredRow = newRow;
+
+        if (hoveredRow >= 0)
+            listBox.repaintRow(hoveredRow);
+    }
+
+    juce::ListBox& listBox;
+    int hoveredRow = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RowHoverTracker)
+};
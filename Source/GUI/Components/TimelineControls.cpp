@@ -9,7 +9,7 @@ TimelineControls::TimelineControls(DrumGrooveProcessor& p, MultiTrackContainer&
 : processor(p), container(c)
 {
     // Create TimelineManager
-    timelineManager = std::make_unique<TimelineManager>(&container);
+    timelineManager = std::make_unique<TimelineManager>(&container, processor.midiFileCache);
     auto& lnf = DrumGrooveLookAndFeel::getInstance();
 
     // File management buttons
@@ -3,11 +3,188 @@
 
 #include "TimelineManager.h"
 #include "MultiTrackContainer.h"
+#include "../../Core/MidiFileStreamWriter.h"
 #include <fstream>
+#include <limits>
 
 //==============================================================================
-TimelineManager::TimelineManager(MultiTrackContainer* container)
-    : container(container)
+namespace
+{
+    constexpr int exportTicksPerQuarterNote = 960;
+    constexpr int exportBufferSize = 64 * 1024;
+
+    double getClipOriginalBpm(const CompactMidiFile& midiFile)
+    {
+        const double bpm = midiFile.getFirstBpm();
+        return bpm > 0.0 ? bpm : 120.0;
+    }
+
+    // Merges the events of several clips into one stream in time order. A clip is
+    // read from the cache once the merge reaches its start and let go once its last
+    // event is out, and only its next event is pending, so memory depends on how
+    // many clips overlap rather than on the length of the arrangement.
+    class ClipEventMerger
+    {
+    public:
+        struct Clip
+        {
+            juce::File file;
+            double startSeconds = 0.0;       // Export time of the clip's tick 0
+            double maxClipSeconds = std::numeric_limits<double>::max();     // Later events end the clip
+            double maxExportSeconds = std::numeric_limits<double>::max();   // Likewise, in export time
+            double minExportSeconds = std::numeric_limits<double>::lowest();  // Earlier events are dropped
+            bool includeMetaEvents = true;   // Sysex is always passed on
+        };
+
+        // A channel message, or a meta or sysex event in message
+        struct Event
+        {
+            double exportSeconds = 0.0;
+            bool isChannelMessage = true;
+            CompactMidiEvent channelMessage;
+            juce::MidiMessage message;
+        };
+
+        explicit ClipEventMerger(MidiFileCache& cache) : midiFileCache(cache) {}
+
+        // All clips are added before the first call to next()
+        void addClip(Clip clip)
+        {
+            jassert(nextSource == 0);
+            sources.push_back({ std::move(clip) });
+        }
+
+        // False once every clip is exhausted
+        bool next(Event& event)
+        {
+            if (nextSource == 0)
+                std::stable_sort(sources.begin(), sources.end(), [](const Source& a, const Source& b)
+                {
+                    return a.clip.startSeconds < b.clip.startSeconds;
+                });
+
+            // A clip's events can't come before its start, so it is opened when the merge gets there
+            while (nextSource < sources.size()
+                   && (pending.empty() || sources[nextSource].clip.startSeconds <= pending.front().exportSeconds))
+                open(nextSource++);
+
+            if (pending.empty())
+                return false;
+
+            std::pop_heap(pending.begin(), pending.end(), isLater);
+            const auto current = pending.back();
+            pending.pop_back();
+
+            auto& source = sources[current.source];
+            event.exportSeconds = current.exportSeconds;
+            event.isChannelMessage = !source.pendingIsOther;
+
+            // Copied out, since the clip's file is released once it is exhausted
+            if (source.pendingIsOther)
+            {
+                const auto& other = source.midiFile->getOtherEvents()[source.nextOther++];
+                event.message = juce::MidiMessage(source.midiFile->getOtherEventData(other), static_cast<int>(other.size));
+            }
+            else
+            {
+                event.channelMessage = source.midiFile->getEvents()[source.nextEvent++];
+            }
+
+            pushNext(current.source);
+            return true;
+        }
+
+    private:
+        struct Source
+        {
+            Clip clip;
+            MidiFileCache::Handle midiFile;
+            double secondsPerTick = 0.0;     // At the clip's original tempo
+            size_t nextEvent = 0;
+            size_t nextOther = 0;
+            bool pendingIsOther = false;
+        };
+
+        struct Pending
+        {
+            double exportSeconds;
+            size_t source;
+        };
+
+        // Ties go to the earlier clip, as a stable sort of all events would
+        static bool isLater(const Pending& a, const Pending& b)
+        {
+            return a.exportSeconds != b.exportSeconds ? a.exportSeconds > b.exportSeconds : a.source > b.source;
+        }
+
+        void open(size_t index)
+        {
+            auto& source = sources[index];
+            source.midiFile = midiFileCache.get(source.clip.file);
+
+            if (source.midiFile == nullptr)
+            {
+                DBG("Export: Could not read " + source.clip.file.getFullPathName());
+                return;
+            }
+
+            source.secondsPerTick = (60.0 / getClipOriginalBpm(*source.midiFile))
+                                  / source.midiFile->getTicksPerQuarterNote(exportTicksPerQuarterNote);
+            pushNext(index);
+        }
+
+        void pushNext(size_t index)
+        {
+            auto& source = sources[index];
+            const auto& events = source.midiFile->getEvents();
+            const auto& others = source.midiFile->getOtherEvents();
+
+            for (;;)
+            {
+                while (!source.clip.includeMetaEvents && source.nextOther < others.size() && others[source.nextOther].isMetaEvent())
+                    ++source.nextOther;
+
+                const bool hasEvent = source.nextEvent < events.size();
+                const bool hasOther = source.nextOther < others.size();
+
+                if (!hasEvent && !hasOther)
+                    break;
+
+                // Meta and sysex events go ahead of channel messages on the same tick
+                const bool takeOther = hasOther && (!hasEvent || others[source.nextOther].tick <= events[source.nextEvent].tick);
+                const auto tick = takeOther ? others[source.nextOther].tick : events[source.nextEvent].tick;
+
+                const double clipSeconds = tick * source.secondsPerTick;
+                const double exportSeconds = source.clip.startSeconds + clipSeconds;
+
+                if (clipSeconds > source.clip.maxClipSeconds || exportSeconds > source.clip.maxExportSeconds)
+                    break;
+
+                if (exportSeconds >= source.clip.minExportSeconds)
+                {
+                    source.pendingIsOther = takeOther;
+                    pending.push_back({ exportSeconds, index });
+                    std::push_heap(pending.begin(), pending.end(), isLater);
+                    return;
+                }
+
+                ++(takeOther ? source.nextOther : source.nextEvent);
+            }
+
+            // Nothing more is needed from this clip; the cache may drop it
+            source.midiFile = nullptr;
+        }
+
+        MidiFileCache& midiFileCache;
+        std::vector<Source> sources;
+        size_t nextSource = 0;
+        std::vector<Pending> pending;
+    };
+}
+
+//==============================================================================
+TimelineManager::TimelineManager(MultiTrackContainer* container, MidiFileCache& fileCache)
+    : container(container), midiFileCache(fileCache)
 {
 }
 
@@ -179,21 +356,16 @@ void TimelineManager::exportTimelineAsMidi()
         return;  // Return WITHOUT creating the file
     }
     
-    // Only create the MIDI file if there are no errors
-    auto midiFile = createCombinedMidiFile();
-    
-    // Ensure MIDI file format 1 for multi-track with tempo
-    if (midiFile.getNumTracks() > 0)
+    // Only create the MIDI file if there are no errors; events are written as they are merged
+    juce::FileOutputStream stream(saveFile, exportBufferSize);
+    if (stream.openedOk())
     {
-        DBG("Writing MIDI file with " + juce::String(midiFile.getNumTracks()) + " tracks");
-        DBG("MIDI file format: " + juce::String(midiFile.getTimeFormat()) + " ticks per quarter note");
+        stream.setPosition(0);
+        stream.truncate();
     }
-    
-    juce::FileOutputStream stream(saveFile);
-    if (stream.openedOk())
+
+    if (stream.openedOk() && writeCombinedMidiFile(std::move(allClipBoundaries), stream))
     {
-        midiFile.writeTo(stream);
-        stream.flush();  // Ensure all data is written
         juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::InfoIcon,
             "Export Complete", "Timeline exported as single MIDI file", "OK");
     }
@@ -278,8 +450,6 @@ void TimelineManager::exportTimelineAsSeparateMidis()
             continue;
         }
         
-        auto midiFile = createMidiFileForTrack(i, !trimSilence);
-        
         // Use actual track name instead of generic "Track_N"
         juce::String trackName = container->getTrackName(i);
         if (trackName.isEmpty() || trackName == "Track " + juce::String(i + 1))
@@ -292,10 +462,9 @@ void TimelineManager::exportTimelineAsSeparateMidis()
         
         auto midiFilePath = targetFolder.getChildFile(trackName + ".mid");
         
-        juce::FileOutputStream stream(midiFilePath);
-        if (stream.openedOk())
+        juce::FileOutputStream stream(midiFilePath, exportBufferSize);
+        if (stream.openedOk() && writeMidiFileForTrack(i, !trimSilence, stream))
         {
-            midiFile.writeTo(stream);
             successCount++;
             DBG("Exported: " + trackName + ".mid");
         }
@@ -484,21 +653,16 @@ void TimelineManager::restoreTimelineMetadata(const juce::ValueTree& state, cons
 }
 
 //==============================================================================
-// FIXED: Complete implementation for per-track MIDI export
-juce::MidiFile TimelineManager::createMidiFileForTrack(int trackIndex, bool includeSilence) const
+bool TimelineManager::writeMidiFileForTrack(int trackIndex, bool includeSilence, juce::OutputStream& output) const
 {
-    juce::MidiFile midiFile;
-    midiFile.setTicksPerQuarterNote(960);
-    
+    MidiFileStreamWriter writer(output, exportTicksPerQuarterNote);
+    writer.beginTrack();
+
     auto clips = container->getTrackClips(trackIndex);
-    
+
     if (clips.empty())
-    {
-        juce::MidiMessageSequence emptySequence;
-        midiFile.addTrack(emptySequence);
-        return midiFile;
-    }
-    
+        return writer.finish();
+
     // Sort clips by start time
     std::vector<const MidiClip*> sortedClips(clips.begin(), clips.end());
     std::sort(sortedClips.begin(), sortedClips.end(),
@@ -513,357 +677,112 @@ juce::MidiFile TimelineManager::createMidiFileForTrack(int trackIndex, bool incl
     DBG("Track BPM: " + juce::String(trackBPM, 2));
     DBG("Start offset: " + juce::String(startOffset, 6));
     DBG("Include silence: " + juce::String(includeSilence ? "YES" : "NO"));
-    if (!sortedClips.empty())
+
+    auto secondsToTicks = [trackBPM](double seconds)
     {
-        DBG("First clip starts at: " + juce::String(sortedClips[0]->startTime, 6) + "s");
-        DBG("Last clip ends at: " + juce::String(sortedClips.back()->startTime + sortedClips.back()->duration, 6) + "s");
-    }
-    
-    // Create the MIDI sequence
-    juce::MidiMessageSequence trackSequence;
-    
-    // CRITICAL FIX: Set tempo at tick 0 with proper format
-    // Tempo must be the FIRST event in the sequence for DAWs to recognize it
+        return static_cast<juce::int64>(juce::roundToInt(seconds * (trackBPM / 60.0) * exportTicksPerQuarterNote));
+    };
+
+    // Tempo must be the FIRST event in the track for DAWs to recognize it
     int microsecondsPerQuarterNote = static_cast<int>(60000000.0 / trackBPM);
-    auto tempoMsg = juce::MidiMessage::tempoMetaEvent(microsecondsPerQuarterNote);
-    trackSequence.addEvent(tempoMsg, 0.0);
-    
-    // Add time signature (4/4) at tick 0
-    auto timeSigMsg = juce::MidiMessage::timeSignatureMetaEvent(4, 4);
-    trackSequence.addEvent(timeSigMsg, 0.0);
-    
-    DBG("Added tempo: " + juce::String(trackBPM, 2) + " BPM (microseconds: " + 
-        juce::String(microsecondsPerQuarterNote) + ") at tick 0");
-    
-    // Process each clip
+    writer.addEvent(juce::MidiMessage::tempoMetaEvent(microsecondsPerQuarterNote), 0);
+    writer.addEvent(juce::MidiMessage::timeSignatureMetaEvent(4, 4), 0);
+
+    ClipEventMerger merger(midiFileCache);
+    double totalDurationSeconds = 0.0;
+
     for (const auto* clip : sortedClips)
     {
+        totalDurationSeconds = juce::jmax(totalDurationSeconds, (clip->startTime - startOffset) + clip->duration);
+
         if (!clip->file.existsAsFile())
             continue;
-        
-        juce::MidiFile clipMidiFile;
-        juce::FileInputStream stream(clip->file);
-        if (!stream.openedOk() || !clipMidiFile.readFrom(stream))
-            continue;
-        
-        // Get clip's original BPM from tempo events
-        double clipOriginalBPM = 120.0;
-        for (int t = 0; t < clipMidiFile.getNumTracks(); ++t)
-        {
-            const auto* track = clipMidiFile.getTrack(t);
-            if (!track) continue;
-            
-            for (int e = 0; e < track->getNumEvents(); ++e)
-            {
-                const auto* event = track->getEventPointer(e);
-                if (event && event->message.isTempoMetaEvent())
-                {
-                    clipOriginalBPM = 60.0 / event->message.getTempoSecondsPerQuarterNote();
-                    DBG("Found clip original BPM: " + juce::String(clipOriginalBPM, 2));
-                    break;
-                }
-            }
-            if (clipOriginalBPM != 120.0) break;
-        }
-        
-        // Calculate where this clip starts in the export
-        double clipStartInTimeline = clip->startTime;
-        double exportClipStartTime = clipStartInTimeline - startOffset;
-        
-        DBG("Clip: " + clip->name);
-        DBG("  Original BPM: " + juce::String(clipOriginalBPM, 2));
-        DBG("  Timeline position: " + juce::String(clipStartInTimeline, 6) + "s");
-        DBG("  Export position: " + juce::String(exportClipStartTime, 6) + "s");
-        DBG("  Duration: " + juce::String(clip->duration, 6) + "s");
-        
-        int eventCount = 0;
-        
-        // Process all MIDI events
-        for (int t = 0; t < clipMidiFile.getNumTracks(); ++t)
-        {
-            const auto* track = clipMidiFile.getTrack(t);
-            if (!track) continue;
-            
-            for (int e = 0; e < track->getNumEvents(); ++e)
-            {
-                const auto* event = track->getEventPointer(e);
-                if (!event) continue;
-                
-                auto message = event->message;
-                
-                // Skip tempo and time signature events (we set our own)
-                if (message.isTempoMetaEvent() || message.isTimeSignatureMetaEvent())
-                    continue;
-                
-                // Skip other meta events that might interfere
-                if (message.isMetaEvent() && !message.isEndOfTrackMetaEvent())
-                    continue;
-                
-                // Get the PPQ from the source file
-                double ticksPerQuarterNote = clipMidiFile.getTimeFormat();
-                if (ticksPerQuarterNote <= 0) ticksPerQuarterNote = 960.0;
-                
-                // Convert event time from ticks to seconds using clip's original BPM
-                double eventTimeInSeconds = (message.getTimeStamp() / ticksPerQuarterNote) * (60.0 / clipOriginalBPM);
-                
-                // Only include events within the clip duration
-                if (eventTimeInSeconds > clip->duration)
-                    continue;
-                
-                // Calculate absolute time in the exported file
-                double absoluteTimeInSeconds = exportClipStartTime + eventTimeInSeconds;
-                
-                if (absoluteTimeInSeconds < 0.0)
-                    continue;
-                
-                // Convert to ticks using the TRACK's BPM (this is the export BPM)
-                double beatsAtTrackBPM = absoluteTimeInSeconds * (trackBPM / 60.0);
-                double ticksAtTrackBPM = beatsAtTrackBPM * 960.0;
-                
-                // Create the event with proper timing
-                juce::MidiMessage exportMessage = message;
-                trackSequence.addEvent(exportMessage, ticksAtTrackBPM);
-                
-                eventCount++;
-                
-                if (eventCount <= 5)  // Log first few events for debugging
-                {
-                    DBG("    Event " + juce::String(eventCount) + 
-                        ": Type=" + (message.isNoteOn() ? "NoteOn" : (message.isNoteOff() ? "NoteOff" : "Other")) +
-                        " Note=" + juce::String(message.getNoteNumber()) +
-                        " at " + juce::String(absoluteTimeInSeconds, 6) + "s" +
-                        " = " + juce::String(ticksAtTrackBPM, 2) + " ticks");
-                }
-            }
-        }
-        
-        DBG("  Added " + juce::String(eventCount) + " events from this clip");
-    }
-    
-    // Add end-of-track event
-    double totalDurationSeconds = 0.0;
-    for (const auto* clip : sortedClips)
-    {
-        double clipEnd = (clip->startTime - startOffset) + clip->duration;
-        totalDurationSeconds = juce::jmax(totalDurationSeconds, clipEnd);
-    }
-    
-    if (totalDurationSeconds > 0.0)
-    {
-        double endTicks = (totalDurationSeconds * (trackBPM / 60.0)) * 960.0;
-        auto endOfTrack = juce::MidiMessage::endOfTrack();
-        trackSequence.addEvent(endOfTrack, endTicks);
-        DBG("Added end-of-track at " + juce::String(totalDurationSeconds, 6) + 
-            "s = " + juce::String(endTicks, 2) + " ticks");
+
+        // Events past the clip's duration are cut, as are events before the export starts.
+        // The track has its own tempo and time signature, so the clips' meta events are left out.
+        ClipEventMerger::Clip source;
+        source.file = clip->file;
+        source.startSeconds = clip->startTime - startOffset;
+        source.maxClipSeconds = clip->duration;
+        source.minExportSeconds = 0.0;
+        source.includeMetaEvents = false;
+        merger.addClip(std::move(source));
+
+        DBG("Clip: " + clip->name + " at " + juce::String(clip->startTime, 6) + "s, duration "
+            + juce::String(clip->duration, 6) + "s");
     }
-    
-    // CRITICAL: Sort the sequence AFTER adding all events
-    trackSequence.sort();
-    trackSequence.updateMatchedPairs();
-    
-    // Add the track to the MIDI file
-    midiFile.addTrack(trackSequence);
-    
-    // Log final statistics
-    int totalEvents = trackSequence.getNumEvents();
-    DBG("Total events in track: " + juce::String(totalEvents));
-    
-    if (totalEvents > 0)
+
+    ClipEventMerger::Event event;
+
+    while (merger.next(event))
     {
-        auto* firstEvent = trackSequence.getEventPointer(0);
-        auto* secondEvent = totalEvents > 1 ? trackSequence.getEventPointer(1) : nullptr;
-        
-        if (firstEvent)
-        {
-            DBG("First event: " + (firstEvent->message.isTempoMetaEvent() ? "Tempo" : 
-                                  (firstEvent->message.isTimeSignatureMetaEvent() ? "TimeSig" : "Other")) +
-                " at tick " + juce::String(firstEvent->message.getTimeStamp()));
-        }
-        
-        if (secondEvent)
-        {
-            DBG("Second event: " + (secondEvent->message.isTempoMetaEvent() ? "Tempo" : 
-                                   (secondEvent->message.isTimeSignatureMetaEvent() ? "TimeSig" : "Other")) +
-                " at tick " + juce::String(secondEvent->message.getTimeStamp()));
-        }
+        const auto tick = secondsToTicks(event.exportSeconds);
+
+        if (event.isChannelMessage)
+            writer.addEvent(event.channelMessage.status, event.channelMessage.data1, event.channelMessage.data2, tick);
+        else
+            writer.addEvent(event.message, tick);
     }
-    
-    DBG("=== Track Export Complete ===");
-    
-    return midiFile;
+
+    writer.endTrack(totalDurationSeconds > 0.0 ? secondsToTicks(totalDurationSeconds) : 0);
+
+    DBG("=== Track Export Complete: " + juce::String(writer.getNumEvents()) + " events ===");
+
+    return writer.finish();
 }
 
 //==============================================================================
 // FIXED: Correct BPM time conversion
-juce::MidiFile TimelineManager::createCombinedMidiFile() const
+bool TimelineManager::writeCombinedMidiFile(std::vector<ClipBoundary> allClipBoundaries, juce::OutputStream& output) const
 {
-    juce::MidiFile midiFile;
-    midiFile.setTicksPerQuarterNote(960);
-    
+    MidiFileStreamWriter writer(output, exportTicksPerQuarterNote);
+    writer.beginTrack();
+
     DBG("=== Creating Combined MIDI File ===");
-    
-    // Collect all clips with their visual boundaries
-    std::vector<ClipBoundary> allClipBoundaries;
-    
-    for (int trackIdx = 0; trackIdx < container->getNumTracks(); ++trackIdx)
-    {
-        double trackBPM = container->getTrackBPM(trackIdx);
-        auto clips = container->getTrackClips(trackIdx);
-        
-        for (const auto* clip : clips)
-        {
-            if (!clip || !clip->file.existsAsFile())
-                continue;
-            
-            ClipBoundary boundary;
-            boundary.startTime = clip->startTime;
-            
-            // CRITICAL: Calculate visual end time considering BPM scaling
-            double visualScaleFactor = clip->referenceBPM / trackBPM;
-            double visualDuration = clip->duration * visualScaleFactor;
-            boundary.endTime = clip->startTime + visualDuration;
-            
-            boundary.bpm = trackBPM;
-            boundary.trackIndex = trackIdx;
-            boundary.clip = clip;
-            
-            allClipBoundaries.push_back(boundary);
-            
-            DBG("Track " + juce::String(trackIdx) + " - Clip: " + clip->name + 
-                " | Start: " + juce::String(boundary.startTime, 3) + 
-                " | End: " + juce::String(boundary.endTime, 3) + 
-                " | BPM: " + juce::String(boundary.bpm, 2));
-        }
-    }
-    
+
     if (allClipBoundaries.empty())
-    {
-        juce::MidiMessageSequence emptySequence;
-        midiFile.addTrack(emptySequence);
-        return midiFile;
-    }
-    
-    // Check for overlaps with different BPMs
-    juce::String errorMessage;
-    if (checkForOverlapsWithDifferentBPM(allClipBoundaries, errorMessage))
-    {
-        juce::AlertWindow::showMessageBoxAsync(
-            juce::AlertWindow::WarningIcon,
-            "Export Error",
-            errorMessage,
-            "OK"
-        );
-        
-        juce::MidiMessageSequence emptySequence;
-        midiFile.addTrack(emptySequence);
-        return midiFile;
-    }
-    
+        return writer.finish();
+
     // Sort clips by start time
     std::sort(allClipBoundaries.begin(), allClipBoundaries.end(),
         [](const ClipBoundary& a, const ClipBoundary& b) {
             return a.startTime < b.startTime;
         });
     
-    // Build tempo map and collect all events
+    // Build tempo map: a change wherever a clip starts at a different BPM
     struct TempoChange {
         double timeInSeconds;
         double bpm;
     };
     std::vector<TempoChange> tempoMap;
-    
-    struct TimedEvent {
-        double timeInSeconds;
-        juce::MidiMessage message;
-    };
-    std::vector<TimedEvent> allEvents;
-    
-    // Process each clip
+
+    ClipEventMerger merger(midiFileCache);
+
     for (const auto& boundary : allClipBoundaries)
     {
         const auto* clip = boundary.clip;
-        
-        // Load the MIDI file
-        juce::MidiFile clipMidiFile;
-        juce::FileInputStream stream(clip->file);
-        if (!stream.openedOk() || !clipMidiFile.readFrom(stream))
-            continue;
-        
-        // Get clip's original BPM
-        double clipOriginalBPM = 120.0;
-        for (int t = 0; t < clipMidiFile.getNumTracks(); ++t)
-        {
-            const auto* track = clipMidiFile.getTrack(t);
-            if (!track) continue;
-            
-            for (int e = 0; e < track->getNumEvents(); ++e)
-            {
-                const auto* event = track->getEventPointer(e);
-                if (event && event->message.isTempoMetaEvent())
-                {
-                    clipOriginalBPM = 60.0 / event->message.getTempoSecondsPerQuarterNote();
-                    break;
-                }
-            }
-            if (clipOriginalBPM != 120.0) break;
-        }
-        
-        // Add tempo change at clip start (if BPM is different from previous)
+
         if (tempoMap.empty() || std::abs(tempoMap.back().bpm - boundary.bpm) > 0.01)
         {
-            TempoChange tc;
-            tc.timeInSeconds = clip->startTime;
-            tc.bpm = boundary.bpm;
-            tempoMap.push_back(tc);
-            
-            DBG("Tempo change: " + juce::String(tc.bpm, 2) + " BPM at " + 
-                juce::String(tc.timeInSeconds, 6) + "s");
-        }
-        
-        // Process all note events
-        for (int t = 0; t < clipMidiFile.getNumTracks(); ++t)
-        {
-            const auto* track = clipMidiFile.getTrack(t);
-            if (!track) continue;
-            
-            for (int e = 0; e < track->getNumEvents(); ++e)
-            {
-                const auto* event = track->getEventPointer(e);
-                if (!event) continue;
-                
-                auto message = event->message;
-                
-                // Skip tempo and time signature events
-                if (message.isTempoMetaEvent() || message.isTimeSignatureMetaEvent())
-                    continue;
-                
-                // Convert event time from MIDI ticks to seconds using clip's original BPM
-                double ticksPerQuarterNote = clipMidiFile.getTimeFormat();
-                if (ticksPerQuarterNote <= 0) ticksPerQuarterNote = 960.0;  // Match our file's PPQ
-                
-                double eventTimeInSeconds = (message.getTimeStamp() / ticksPerQuarterNote) * (60.0 / clipOriginalBPM);
-                
-                // Calculate absolute time in export
-                double absoluteTime = clip->startTime + eventTimeInSeconds;
-                
-                // Only add if within clip's visual boundaries
-                if (absoluteTime >= clip->startTime && absoluteTime <= boundary.endTime)
-                {
-                    TimedEvent te;
-                    te.timeInSeconds = absoluteTime;
-                    te.message = message;
-                    allEvents.push_back(te);
-                }
-            }
+            tempoMap.push_back({ clip->startTime, boundary.bpm });
+
+            DBG("Tempo change: " + juce::String(boundary.bpm, 2) + " BPM at " + 
+                juce::String(clip->startTime, 6) + "s");
         }
+
+        // Only events within the clip's visual boundaries are exported; the clips' own
+        // tempo and time signature changes are replaced by the tempo map
+        ClipEventMerger::Clip source;
+        source.file = clip->file;
+        source.startSeconds = clip->startTime;
+        source.maxExportSeconds = boundary.endTime;
+        source.minExportSeconds = clip->startTime;
+        merger.addClip(std::move(source));
     }
-    
-    // Convert everything to MIDI ticks considering tempo changes
-    juce::MidiMessageSequence combinedSequence;
-    
+
     // Function to convert seconds to ticks with variable tempo
     auto secondsToTicks = [&tempoMap](double seconds) -> double {
-        if (tempoMap.empty()) return seconds * (120.0 / 60.0) * 960.0;
+        if (tempoMap.empty()) return seconds * (120.0 / 60.0) * exportTicksPerQuarterNote;
         
         double ticks = 0.0;
         double prevTime = 0.0;
@@ -876,7 +795,7 @@ juce::MidiFile TimelineManager::createCombinedMidiFile() const
             
             double deltaSeconds = tc.timeInSeconds - prevTime;
             double deltaBeats = deltaSeconds * (prevBPM / 60.0);
-            ticks += deltaBeats * 960.0;
+            ticks += deltaBeats * exportTicksPerQuarterNote;
             
             prevTime = tc.timeInSeconds;
             prevBPM = tc.bpm;
@@ -884,42 +803,53 @@ juce::MidiFile TimelineManager::createCombinedMidiFile() const
         
         double deltaSeconds = seconds - prevTime;
         double deltaBeats = deltaSeconds * (prevBPM / 60.0);
-        ticks += deltaBeats * 960.0;
+        ticks += deltaBeats * exportTicksPerQuarterNote;
         
         return ticks;
     };
-    
-    // Add tempo changes to MIDI
-    for (const auto& tc : tempoMap)
+
+    // Tempo changes go out between the notes, ahead of any note on the same tick
+    size_t nextTempoChange = 0;
+    auto writeTempoChangesUpTo = [&](juce::int64 tick)
     {
-        double ticks = secondsToTicks(tc.timeInSeconds);
-        int microsecondsPerQuarterNote = static_cast<int>(60000000.0 / tc.bpm);
-        combinedSequence.addEvent(juce::MidiMessage::tempoMetaEvent(microsecondsPerQuarterNote), ticks);
-    }
-    
-    // Add time signature at tick 0 for better DAW compatibility
-    juce::MidiMessage timeSigMsg = juce::MidiMessage::timeSignatureMetaEvent(4, 4);
-    timeSigMsg.setTimeStamp(0);
-    combinedSequence.addEvent(timeSigMsg, 0.0);
-    
-    // Add all note events
-    for (const auto& te : allEvents)
+        for (; nextTempoChange < tempoMap.size(); ++nextTempoChange)
+        {
+            const auto& tc = tempoMap[nextTempoChange];
+            const auto tempoTick = static_cast<juce::int64>(juce::roundToInt(secondsToTicks(tc.timeInSeconds)));
+
+            if (tempoTick > tick)
+                break;
+
+            int microsecondsPerQuarterNote = static_cast<int>(60000000.0 / tc.bpm);
+            writer.addEvent(juce::MidiMessage::tempoMetaEvent(microsecondsPerQuarterNote), tempoTick);
+        }
+    };
+
+    // Time signature at tick 0 for better DAW compatibility
+    writeTempoChangesUpTo(0);
+    writer.addEvent(juce::MidiMessage::timeSignatureMetaEvent(4, 4), 0);
+
+    ClipEventMerger::Event event;
+
+    while (merger.next(event))
     {
-        double eventTicks = secondsToTicks(te.timeInSeconds);
-        auto message = te.message;
-        message.setTimeStamp(static_cast<int>(eventTicks + 0.5));  // Round to nearest tick
-        combinedSequence.addEvent(message);
+        const auto eventTicks = static_cast<juce::int64>(secondsToTicks(event.exportSeconds) + 0.5);   // Round to nearest tick
+        writeTempoChangesUpTo(eventTicks);
+
+        if (event.isChannelMessage)
+            writer.addEvent(event.channelMessage.status, event.channelMessage.data1, event.channelMessage.data2, eventTicks);
+        else
+            writer.addEvent(event.message, eventTicks);
     }
-    
-    combinedSequence.updateMatchedPairs();
-    combinedSequence.sort();
-    midiFile.addTrack(combinedSequence);
-    
+
+    writeTempoChangesUpTo(std::numeric_limits<juce::int64>::max());
+    writer.endTrack();
+
     DBG("=== Export Complete ===");
-    DBG("Total events: " + juce::String(allEvents.size()));
-    DBG("Tempo changes: " + juce::String(tempoMap.size()));
-    
-    return midiFile;
+    DBG("Total events: " + juce::String(writer.getNumEvents()));
+    DBG("Tempo changes: " + juce::String(static_cast<int>(tempoMap.size())));
+
+    return writer.finish();
 }
 
 bool TimelineManager::checkForOverlapsWithDifferentBPM(const std::vector<ClipBoundary>& boundaries, juce::String& errorMessage) const
@@ -1,6 +1,7 @@
 #pragma once
 #include <JuceHeader.h>
 #include "Track.h"
+#include "../../Core/MidiFileCache.h"
 
 class MultiTrackContainer;
 
@@ -10,7 +11,7 @@ class MultiTrackContainer;
 class TimelineManager
 {
 public:
-    TimelineManager(MultiTrackContainer* container);
+    TimelineManager(MultiTrackContainer* container, MidiFileCache& midiFileCache);
     ~TimelineManager();
 
     // File operations
@@ -25,6 +26,7 @@ public:
 
 private:
     MultiTrackContainer* container;
+    MidiFileCache& midiFileCache;
     bool dragInProgress = false;
     juce::File lastTempDragFile; 
 	
@@ -39,16 +41,7 @@ private:
     void createTimelineMetadata(juce::ValueTree& state, const juce::File& folder) const;
     void restoreTimelineMetadata(const juce::ValueTree& state, const juce::File& folder);
     
-    // MIDI export helpers
-    juce::MidiFile createMidiFileForTrack(int trackIndex, bool includeSilence) const;
-    juce::MidiFile createCombinedMidiFile() const;
-    void addSilenceToMidiFile(juce::MidiFile& midiFile, double silenceDuration, int trackIndex) const;
-    
-    // Drag and drop helpers
-    juce::var createDragDataForSelectedClips() const;
-    void performExternalDrag(const juce::MouseEvent& e, const juce::var& dragData);
-	
-	// Overlap detection helper
+    // A clip's span on the timeline, at its track's BPM
     struct ClipBoundary {
         double startTime;
         double endTime;
@@ -56,6 +49,17 @@ private:
         int trackIndex;
         const MidiClip* clip;
     };
+
+    // MIDI export helpers; events are merged from the clips and streamed to the output in time order
+    bool writeMidiFileForTrack(int trackIndex, bool includeSilence, juce::OutputStream& output) const;
+    bool writeCombinedMidiFile(std::vector<ClipBoundary> allClipBoundaries, juce::OutputStream& output) const;
+    void addSilenceToMidiFile(juce::MidiFile& midiFile, double silenceDuration, int trackIndex) const;
+    
+    // Drag and drop helpers
+    juce::var createDragDataForSelectedClips() const;
+    void performExternalDrag(const juce::MouseEvent& e, const juce::var& dragData);
+	
+	// Overlap detection helper
     bool checkForOverlapsWithDifferentBPM(const std::vector<ClipBoundary>& boundaries, juce::String& errorMessage) const;
     
 	// Folder safety checks
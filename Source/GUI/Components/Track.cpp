@@ -4,6 +4,7 @@
 #include "MultiTrackContainer.h"
 #include "../../Utils/TimelineUtils.h"
 #include "../../Core/MidiDissector.h"
+#include "../../Core/GrooveLibraryIndex.h"
 #include "../LookAndFeel/DrumGrooveLookAndFeel.h"
 #include "../LookAndFeel/ColourPalette.h"
 
@@ -158,76 +159,27 @@ void Track::drawMidiDotsInClip(juce::Graphics& g, const MidiClip& clip, juce::Re
         g.drawVerticalLine(static_cast<int>(x), dotArea.getY(), dotArea.getBottom());
     }
 
-    // Read MIDI file
-    juce::FileInputStream stream(clip.file);
-    if (!stream.openedOk())
+    // Parsed once and shared with the player; repaints are served from memory
+    const auto handle = processor.midiFileCache.get(clip.file);
+    if (handle == nullptr)
         return;
 
-    juce::MidiFile midiFile;
-    if (!midiFile.readFrom(stream))
-        return;
+    const auto& midiFile = *handle;
 
-    double ticksPerQuarterNote = midiFile.getTimeFormat();
-    if (ticksPerQuarterNote <= 0)
-        ticksPerQuarterNote = 480.0;
+    const double ticksPerQuarterNote = midiFile.getTicksPerQuarterNote();
 
-    // Determine the actual BPM used by the clip
-    double midiFileBPM = 120.0;
-    
-    for (int t = 0; t < midiFile.getNumTracks(); ++t)
-    {
-        const juce::MidiMessageSequence* track = midiFile.getTrack(t);
-        if (track)
-        {
-            for (int i = 0; i < track->getNumEvents(); ++i)
-            {
-                auto* eventHolder = track->getEventPointer(i);
-                if (eventHolder && eventHolder->message.isTempoMetaEvent())
-                {
-                    midiFileBPM = 60.0 / eventHolder->message.getTempoSecondsPerQuarterNote();
-                    break;
-                }
-            }
-            if (midiFileBPM != 120.0) break;
-        }
-    }
-
-    double maxTimeStamp = 0;
-    juce::MidiMessageSequence allNotes;
     int minNoteNumber = 127;
     int maxNoteNumber = 0;
-    
-    // Collect all note events
-    for (int t = 0; t < midiFile.getNumTracks(); ++t)
+
+    for (const auto& event : midiFile.getEvents())
     {
-        const juce::MidiMessageSequence* track = midiFile.getTrack(t);
-        if (track)
+        if (event.isNoteOn())
         {
-            for (int i = 0; i < track->getNumEvents(); ++i)
-            {
-                auto* eventHolder = track->getEventPointer(i);
-                if (eventHolder)
-                {
-                    const auto& message = eventHolder->message;
-                    
-                    if (message.isNoteOn())
-                    {
-                        allNotes.addEvent(message);
-                        int noteNum = message.getNoteNumber();
-                        minNoteNumber = juce::jmin(minNoteNumber, noteNum);
-                        maxNoteNumber = juce::jmax(maxNoteNumber, noteNum);
-                    }
-                    
-                    maxTimeStamp = juce::jmax(maxTimeStamp, message.getTimeStamp());
-                }
-            }
+            minNoteNumber = juce::jmin(minNoteNumber, static_cast<int>(event.data1));
+            maxNoteNumber = juce::jmax(maxNoteNumber, static_cast<int>(event.data1));
         }
     }
 
-    allNotes.sort();
-    allNotes.updateMatchedPairs();
-
-    // double midiDurationInSeconds = (maxTimeStamp / ticksPerQuarterNote) * (60.0 / 120.0);
     double visualDuration = juce::jmax(0.1, clip.duration);
 
     int noteRange = juce::jmax(1, maxNoteNumber - minNoteNumber);
@@ -236,20 +188,18 @@ void Track::drawMidiDotsInClip(juce::Graphics& g, const MidiClip& clip, juce::Re
     bool isFullMidiFile = (clip.colour == ColourPalette::primaryBlue.withAlpha(0.7f));
     
     // Draw note events with appropriate coloring
-    for (int i = 0; i < allNotes.getNumEvents(); ++i)
+    for (const auto& event : midiFile.getEvents())
     {
-        const auto& event = allNotes.getEventPointer(i)->message;
-
         if (event.isNoteOn())
         {
-            double noteTime = (event.getTimeStamp() / ticksPerQuarterNote) * (60.0 / 120.0);
+            double noteTime = (event.tick / ticksPerQuarterNote) * (60.0 / 120.0);
             float relativeX = static_cast<float>(noteTime / visualDuration);
             
             if (relativeX >= 0.0f && relativeX <= 1.0f)
             {
                 float dotX = dotArea.getX() + relativeX * dotArea.getWidth();
                 
-                int noteNumber = event.getNoteNumber();
+                int noteNumber = event.data1;
                 float relativeY = 1.0f - static_cast<float>(noteNumber - minNoteNumber) / static_cast<float>(noteRange);
                 float dotY = dotArea.getY() + relativeY * dotArea.getHeight();
 
@@ -258,7 +208,7 @@ void Track::drawMidiDotsInClip(juce::Graphics& g, const MidiClip& clip, juce::Re
                 if (isFullMidiFile)
                 {
                     // For full MIDI files: color each note based on its drum part type
-                    DrumPartType notePartType = MidiDissector::getPartTypeFromNote(event.getNoteNumber());
+                    DrumPartType notePartType = MidiDissector::getPartTypeFromNote(noteNumber);
                     noteColour = MidiDissector::getPartColour(notePartType).brighter(0.3f);
                 }
                 else
@@ -341,6 +291,8 @@ void Track::handleMidiFileDrop(const juce::StringArray& parts, const juce::Point
     newClip.colour = ColourPalette::primaryBlue.withAlpha(0.7f);
     newClip.referenceBPM = getTrackBPM();
 
+    processor.usageTracker.recordUse(file, GrooveUsageTracker::Action::Drop);
+
     // Calculate duration
     double duration = 4.0;
     if (calculateMidiFileDuration(file, duration))
@@ -399,6 +351,8 @@ void Track::handleDrumPartDrop(const juce::StringArray& parts, const juce::Point
     if (!createDrumPartMidiFile(originalFile, partType, sourceLib, outputFile))
         return;
 
+    processor.usageTracker.recordUse(originalFile, GrooveUsageTracker::Action::Drop);
+
     MidiClip newClip;
     newClip.name = partName;
     newClip.file = outputFile;
@@ -447,14 +401,9 @@ bool Track::createDrumPartMidiFile(const juce::File& originalFile,
     DBG("Original file: " + originalFile.getFullPathName());
     DBG("Part type: " + juce::String(static_cast<int>(partType)));
     
-    MidiDissector dissector;
     DrumLibrary targetLib = processor.getTargetLibrary();
 
-    auto parts = dissector.dissectMidiFileWithLibraryManager(
-        originalFile, 
-        sourceLib, 
-        targetLib,
-        processor.drumLibraryManager);
+    auto parts = processor.dissectionCache.getDrumParts(originalFile, sourceLib, targetLib);
 
     DBG("Found " + juce::String(parts.size()) + " parts");
 
@@ -471,9 +420,9 @@ bool Track::createDrumPartMidiFile(const juce::File& originalFile,
             midiFileToSave.setTicksPerQuarterNote(480);
             
             juce::MidiMessageSequence trackCopy;
-            for (int i = 0; i < part.sequence.getNumEvents(); ++i)
+            for (int i = 0; i < part.getSequence().getNumEvents(); ++i)
             {
-                trackCopy.addEvent(part.sequence.getEventPointer(i)->message);
+                trackCopy.addEvent(part.getSequence().getEventPointer(i)->message);
             }
             trackCopy.updateMatchedPairs();
             
@@ -510,31 +459,21 @@ bool Track::createDrumPartMidiFile(const juce::File& originalFile,
 
 bool Track::calculateMidiFileDuration(const juce::File& file, double& duration) const
 {
-    juce::FileInputStream stream(file);
-    if (!stream.openedOk())
-        return false;
+    // Indexed files snap to whole bars of their meter without being parsed
+    auto snapshot = processor.drumLibraryManager.getLibraryIndex().getSnapshot();
+    const int row = snapshot->indexOf(file);
+    if (row >= 0 && snapshot->getBarCount(row) > 0)
+    {
+        duration = snapshot->getBarCount(row) * snapshot->getQuartersPerBar(row) * (60.0 / 120.0);
+        return true;
+    }
 
-    juce::MidiFile midiFile;
-    if (!midiFile.readFrom(stream))
+    const auto midiFile = processor.midiFileCache.get(file);
+    if (midiFile == nullptr)
         return false;
 
-    double ticksPerQuarterNote = midiFile.getTimeFormat();
-    if (ticksPerQuarterNote <= 0)
-        ticksPerQuarterNote = 480.0;
-
-    double maxTimeStamp = 0;
-    for (int t = 0; t < midiFile.getNumTracks(); ++t)
-    {
-        const juce::MidiMessageSequence* track = midiFile.getTrack(t);
-        if (track && track->getNumEvents() > 0)
-        {
-            auto lastEvent = track->getEventPointer(track->getNumEvents() - 1);
-            if (lastEvent)
-            {
-                maxTimeStamp = juce::jmax(maxTimeStamp, lastEvent->message.getTimeStamp());
-            }
-        }
-    }
+    const double ticksPerQuarterNote = midiFile->getTicksPerQuarterNote();
+    const double maxTimeStamp = midiFile->getLastTick();
 
     duration = (maxTimeStamp / ticksPerQuarterNote) * (60.0 / 120.0);
     return duration > 0;
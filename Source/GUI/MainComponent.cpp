@@ -33,6 +33,11 @@ MainComponent::MainComponent(DrumGrooveProcessor& p)
             grooveBrowser->loadFolderContents(folder);
     };
 
+    folderPanel->onCollectionSelected = [this](const juce::String& collectionId) {
+        if (grooveBrowser)
+            grooveBrowser->showCollection(collectionId);
+    };
+
     // Connect groove browser file selection to file path display
     grooveBrowser->onFileSelected = [this](const juce::File& file) {
         handleFileSelected(file);
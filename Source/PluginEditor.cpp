@@ -12,6 +12,9 @@ DrumGrooveEditor::DrumGrooveEditor(DrumGrooveProcessor& p)
     mainComponent = std::make_unique<MainComponent>(processor);
     addAndMakeVisible(mainComponent.get());
 
+    // Have the grooves used most and last ready before the first audition
+    processor.usageTracker.warmUp(processor.drumLibraryManager.getLastSelectedTargetLibrary());
+
     // Set constraints
     setResizable(true, true);
     setResizeLimits(900, 600, 2000, 1200);
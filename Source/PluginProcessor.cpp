@@ -1,4 +1,5 @@
 #include "PluginProcessor.h"
+#include "Core/GrooveLibraryIndex.h"
 #include "PluginEditor.h"
 #include "GUI/MainComponent.h"
 #include "GUI/Components/MultiTrackContainer.h"
@@ -13,9 +14,22 @@ DrumGrooveProcessor::DrumGrooveProcessor()
 #endif
 ),
 parameters(*this, nullptr, juce::Identifier("DrumGrooveProParams"), createParameterLayout()),
-midiProcessor(drumLibraryManager)
+midiProcessor(drumLibraryManager, midiFileCache),
+dissectionCache(drumLibraryManager),
+usageTracker(drumLibraryManager, dissectionCache)
 {
     drumLibraryManager.loadConfiguration();
+    dissectionCache.setMemoryLimit(drumLibraryManager.getCacheMemoryLimit());
+
+    // Files changed on disk must not be served from the caches
+    drumLibraryManager.getLibraryIndex().setFilesChangedCallback([this](const juce::StringArray& paths)
+    {
+        for (const auto& path : paths)
+        {
+            dissectionCache.invalidate(juce::File(path));
+            midiFileCache.invalidate(juce::File(path));
+        }
+    });
 
     // Initialize GUI state tree with default values
     guiStateTree.setProperty("currentBrowserFolder", "", nullptr);
@@ -35,6 +49,7 @@ midiProcessor(drumLibraryManager)
 DrumGrooveProcessor::~DrumGrooveProcessor()
 {
     parameters.state.removeListener(this);
+    drumLibraryManager.getLibraryIndex().setFilesChangedCallback(nullptr);
     drumLibraryManager.saveConfiguration();
 }
 
@@ -138,6 +153,9 @@ void DrumGrooveProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::M
         currentBPM = parameters.getRawParameterValue("manualBPM")->load();
     }
 
+    // Read by the editor on the message thread; nothing is posted from here
+    effectiveBPM.store(currentBPM);
+
     // Get target library
     int libraryIndex = static_cast<int>(parameters.getRawParameterValue("targetLibrary")->load());
     DrumLibrary targetLibrary = static_cast<DrumLibrary>(libraryIndex + 1);
@@ -4,6 +4,10 @@
 #include "Core/MidiProcessor.h"
 #include "Core/DrumLibraryManager.h"
 #include "Core/FavoritesManager.h"
+#include "Core/DissectionCache.h"
+#include "Core/MidiFileCache.h"
+#include "Core/GrooveUsageTracker.h"
+#include <atomic>
 
 // Forward declaration
 class MultiTrackContainer;
@@ -48,7 +52,10 @@ public:
     // Public access to core components
     juce::AudioProcessorValueTreeState parameters;
     DrumLibraryManager drumLibraryManager;
+    MidiFileCache midiFileCache;        // Parsed grooves for the timeline and playback
     MidiProcessor midiProcessor;
+    DissectionCache dissectionCache;
+    GrooveUsageTracker usageTracker;    // Warms dissectionCache
 
     // BPM access methods
     double getHostBPM() const
@@ -62,6 +69,9 @@ public:
         return 120.0;
     }
 
+    // Tempo used by the last processed block
+    double getEffectiveBPM() const { return effectiveBPM.load(); }
+
     bool isHostPlaying() const
     {
         if (auto* playHead = getPlayHead())
@@ -161,5 +171,7 @@ private:
     // Internal GUI state storage in ValueTree
     juce::ValueTree guiStateTree { "GuiState" };
 
+    std::atomic<double> effectiveBPM { 120.0 };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DrumGrooveProcessor)
 };
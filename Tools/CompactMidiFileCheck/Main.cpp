@@ -0,0 +1,313 @@
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "CompactMidiFile.h"
+#include <algorithm>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+/*
+ * Fuzz and benchmark check for CompactMidiFile.
+ *
+ *   CompactMidiFileCheck [iterations] [seed] [folder of .mid files]
+ *
+ * Well-formed files, generated with juce::MidiFile and taken from the optional
+ * folder, must read back with the same channel events, ticks and track count
+ * as juce::MidiFile reads them. Truncated, mutated and random inputs must be
+ * rejected or read into a consistent event list; build with
+ * -fsanitize=address,undefined to catch reads past the data. Finally both
+ * readers are timed over the well-formed files.
+ */
+
+namespace
+{
+    using EventKey = std::tuple<juce::uint32, int, int, int>;   // tick, status, data1, data2
+
+    struct JuceResult
+    {
+        bool ok = false;
+        int numTracks = 0;
+        short timeFormat = 0;
+        std::vector<EventKey> events;
+    };
+
+    juce::MemoryBlock createRandomFile(juce::Random& random)
+    {
+        juce::MidiFile midiFile;
+        midiFile.setTicksPerQuarterNote(random.nextBool() ? 480 : 24 + random.nextInt(1000));
+
+        const int numTracks = 1 + random.nextInt(4);
+        for (int trackIndex = 0; trackIndex < numTracks; ++trackIndex)
+        {
+            juce::MidiMessageSequence track;
+            double tick = 0.0;
+
+            if (trackIndex == 0)
+            {
+                track.addEvent(juce::MidiMessage::tempoMetaEvent(300000 + random.nextInt(700000)), 0.0);
+                track.addEvent(juce::MidiMessage::timeSignatureMetaEvent(2 + random.nextInt(6), 4), 0.0);
+            }
+
+            const int numEvents = random.nextInt(2000);
+            for (int i = 0; i < numEvents; ++i)
+            {
+                // Runs of events on one tick and one channel exercise running status
+                if (random.nextInt(4) != 0)
+                    tick += random.nextInt(240);
+
+                const int channel = 1 + random.nextInt(16);
+
+                switch (random.nextInt(10))
+                {
+                    case 0:  track.addEvent(juce::MidiMessage::controllerEvent(channel, random.nextInt(120), random.nextInt(128)), tick); break;
+                    case 1:  track.addEvent(juce::MidiMessage::programChange(channel, random.nextInt(128)), tick); break;
+                    case 2:  track.addEvent(juce::MidiMessage::pitchWheel(channel, random.nextInt(16384)), tick); break;
+                    case 3:  track.addEvent(juce::MidiMessage::channelPressureChange(channel, random.nextInt(128)), tick); break;
+                    case 4:  track.addEvent(juce::MidiMessage::textMetaEvent(1, "marker " + juce::String(i)), tick); break;
+                    case 5:
+                    {
+                        const juce::uint8 sysex[] = { 0x7e, 0x7f, 0x09, 0x01 };
+                        track.addEvent(juce::MidiMessage::createSysExMessage(sysex, static_cast<int>(sizeof(sysex))), tick);
+                        break;
+                    }
+                    default:
+                        track.addEvent(juce::MidiMessage::noteOn(channel, random.nextInt(128), static_cast<juce::uint8>(random.nextInt(128))), tick);
+                        break;
+                }
+            }
+
+            midiFile.addTrack(track);
+        }
+
+        juce::MemoryOutputStream output;
+        midiFile.writeTo(output);
+        return output.getMemoryBlock();
+    }
+
+    juce::MemoryBlock mutate(const juce::MemoryBlock& source, juce::Random& random)
+    {
+        juce::MemoryBlock data(source);
+
+        switch (random.nextInt(4))
+        {
+            case 0:
+                data.setSize(static_cast<size_t>(random.nextInt(static_cast<int>(data.getSize()) + 1)));
+                break;
+
+            case 1:
+                for (int i = 1 + random.nextInt(8); --i >= 0 && data.getSize() > 0;)
+                    data[static_cast<int>(random.nextInt(static_cast<int>(data.getSize())))] ^= static_cast<char>(1 + random.nextInt(255));
+                break;
+
+            case 2:
+            {
+                char bytes[16];
+                const int numBytes = 1 + random.nextInt(static_cast<int>(sizeof(bytes)));
+                random.fillBitsRandomly(bytes, static_cast<size_t>(numBytes));
+                data.insert(bytes, static_cast<size_t>(numBytes), static_cast<size_t>(random.nextInt(static_cast<int>(data.getSize()) + 1)));
+                break;
+            }
+
+            default:
+                // Random bytes behind the file header and the first track header, so the track reader sees them
+                data.setSize(static_cast<size_t>(22 + random.nextInt(4096)), true);
+                random.fillBitsRandomly(static_cast<char*>(data.getData()) + 22, data.getSize() - 22);
+                break;
+        }
+
+        return data;
+    }
+
+    JuceResult readWithJuce(const juce::MemoryBlock& data)
+    {
+        JuceResult result;
+        juce::MemoryInputStream input(data, false);
+        juce::MidiFile midiFile;
+
+        // No added note-offs, so both readers see the same events
+        result.ok = midiFile.readFrom(input, false);
+        if (!result.ok)
+            return result;
+
+        result.numTracks = midiFile.getNumTracks();
+        result.timeFormat = midiFile.getTimeFormat();
+
+        for (int trackIndex = 0; trackIndex < midiFile.getNumTracks(); ++trackIndex)
+        {
+            for (const auto* holder : *midiFile.getTrack(trackIndex))
+            {
+                const auto& message = holder->message;
+                const auto* raw = message.getRawData();
+                const int size = message.getRawDataSize();
+
+                if (size > 0 && raw[0] >= 0x80 && raw[0] < 0xf0)
+                    result.events.emplace_back(static_cast<juce::uint32>(message.getTimeStamp()), raw[0],
+                                               size > 1 ? raw[1] : 0, size > 2 ? raw[2] : 0);
+            }
+        }
+
+        std::sort(result.events.begin(), result.events.end());
+        return result;
+    }
+
+    std::vector<EventKey> getEventKeys(const CompactMidiFile& midiFile)
+    {
+        std::vector<EventKey> keys;
+        keys.reserve(midiFile.getEvents().size());
+
+        for (const auto& event : midiFile.getEvents())
+            keys.emplace_back(event.tick, event.status, event.data1, event.data2);
+
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    bool isConsistent(const CompactMidiFile& midiFile)
+    {
+        juce::uint32 previousTick = 0;
+
+        for (const auto& event : midiFile.getEvents())
+        {
+            if (event.tick < previousTick || event.tick > midiFile.getLastTick()
+                || event.status < 0x80 || event.status >= 0xf0 || event.data1 > 0x7f || event.data2 > 0x7f)
+                return false;
+
+            previousTick = event.tick;
+        }
+
+        for (const auto& event : midiFile.getOtherEvents())
+        {
+            if (event.tick > midiFile.getLastTick() || event.size == 0
+                || static_cast<size_t>(event.offset) + event.size > midiFile.getOtherEventDataSize()
+                || midiFile.getOtherEventData(event)[0] != event.status)
+                return false;
+        }
+
+        return true;
+    }
+
+    juce::String compareWithJuce(const juce::MemoryBlock& data)
+    {
+        const auto expected = readWithJuce(data);
+
+        CompactMidiFile midiFile;
+        const bool ok = midiFile.readFrom(data.getData(), data.getSize());
+
+        if (ok != expected.ok)
+            return ok ? "read, but juce::MidiFile rejects it" : "rejected, but juce::MidiFile reads it";
+
+        if (!ok)
+            return {};
+
+        if (midiFile.getNumTracks() != expected.numTracks)
+            return juce::String(midiFile.getNumTracks()) + " tracks instead of " + juce::String(expected.numTracks);
+
+        if (midiFile.getTimeFormat() != expected.timeFormat)
+            return "time format " + juce::String(midiFile.getTimeFormat()) + " instead of " + juce::String(expected.timeFormat);
+
+        if (getEventKeys(midiFile) != expected.events)
+            return juce::String(static_cast<int>(midiFile.getEvents().size())) + " events instead of "
+                 + juce::String(static_cast<int>(expected.events.size())) + ", or different ticks or data";
+
+        return {};
+    }
+
+    template <typename ReadFunction>
+    double timeReads(const std::vector<juce::MemoryBlock>& files, int passes, ReadFunction&& read)
+    {
+        const double start = juce::Time::getMillisecondCounterHiRes();
+
+        for (int pass = 0; pass < passes; ++pass)
+            for (const auto& data : files)
+                read(data);
+
+        return (juce::Time::getMillisecondCounterHiRes() - start) / 1000.0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int iterations = argc > 1 ? juce::String(argv[1]).getIntValue() : 20000;
+    juce::Random random(argc > 2 ? juce::String(argv[2]).getLargeIntValue() : 1);
+
+    std::vector<juce::MemoryBlock> corpus;
+    for (int i = 0; i < 64; ++i)
+        corpus.push_back(createRandomFile(random));
+
+    if (argc > 3)
+    {
+        const auto folder = juce::File::getCurrentWorkingDirectory().getChildFile(argv[3]);
+        for (const auto& entry : juce::RangedDirectoryIterator(folder, true, "*.mid;*.midi;*.MID;*.MIDI"))
+        {
+            juce::MemoryBlock data;
+            if (entry.getFile().loadFileAsData(data))
+                corpus.push_back(std::move(data));
+        }
+    }
+
+    int failures = 0;
+
+    for (size_t i = 0; i < corpus.size(); ++i)
+    {
+        const auto difference = compareWithJuce(corpus[i]);
+        if (difference.isNotEmpty())
+        {
+            std::cout << "File " << i << ": " << difference << std::endl;
+            ++failures;
+        }
+    }
+
+    // Damaged files only have to be handled safely; where both readers accept one they may still differ
+    int accepted = 0, differences = 0;
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        const auto data = mutate(corpus[static_cast<size_t>(random.nextInt(static_cast<int>(corpus.size())))], random);
+
+        CompactMidiFile midiFile;
+        if (!midiFile.readFrom(data.getData(), data.getSize()))
+            continue;
+
+        ++accepted;
+
+        if (!isConsistent(midiFile))
+        {
+            std::cout << "Mutation " << i << ": inconsistent events" << std::endl;
+            ++failures;
+        }
+        else if (compareWithJuce(data).isNotEmpty())
+        {
+            ++differences;
+        }
+    }
+
+    std::cout << iterations << " damaged inputs, " << accepted << " read, "
+              << differences << " read differently by juce::MidiFile" << std::endl;
+
+    size_t totalBytes = 0;
+    for (const auto& data : corpus)
+        totalBytes += data.getSize();
+
+    constexpr int passes = 20;
+    const double megabytes = static_cast<double>(totalBytes) * passes / (1024.0 * 1024.0);
+
+    const double compactSeconds = timeReads(corpus, passes, [](const juce::MemoryBlock& data)
+    {
+        CompactMidiFile midiFile;
+        midiFile.readFrom(data.getData(), data.getSize());
+    });
+
+    const double juceSeconds = timeReads(corpus, passes, [](const juce::MemoryBlock& data)
+    {
+        juce::MemoryInputStream input(data, false);
+        juce::MidiFile midiFile;
+        midiFile.readFrom(input, false);
+    });
+
+    std::cout << "CompactMidiFile: " << juce::String(megabytes / compactSeconds, 1) << " MB/s, juce::MidiFile: "
+              << juce::String(megabytes / juceSeconds, 1) << " MB/s" << std::endl;
+
+    if (failures > 0)
+        std::cout << failures << " failures" << std::endl;
+
+    return failures > 0 ? 1 : 0;
+}